@@ -0,0 +1,117 @@
+#pragma once
+
+#include "aes_utils/aes_utils.hpp"
+
+namespace aes_utils {
+/**
+    AES-CMAC message authentication code (NIST SP 800-38B, RFC 4493).
+    Subkeys are derived once on construction, tag computation works both
+    at compile time and at runtime.
+*/
+template <size_t key_length>
+class aes_cmac {
+private:
+    static constexpr uint8_t r_b = 0x87;
+
+    /// @return data shifted left by one bit, xored with R_b if the top bit was set
+    template <size_t ... index_seq>
+    static constexpr quad_word subkey_helper(const quad_word& data, std::index_sequence<index_seq...>) noexcept
+    {
+        return quad_word(static_cast<uint8_t>((data[index_seq] << 1)
+            ^ (index_seq == 15 ? ((data[0] & 0x80) ? r_b : 0x00) : (data[(index_seq + 1) % 16] >> 7))) ...);
+    }
+    static constexpr quad_word subkey(const quad_word& data) noexcept
+    {
+        return subkey_helper(data, std::make_index_sequence<16>());
+    }
+    /// @return block of count bytes read from data, padded with 0x80 0x00 ... if count < 16
+    template <typename Byte, size_t ... index_seq>
+    static constexpr quad_word load_block_helper(const Byte* data, size_t count, std::index_sequence<index_seq...>) noexcept
+    {
+        return quad_word((index_seq < count ? static_cast<uint8_t>(data[index_seq]) : (index_seq == count ? 0x80 : 0x00)) ...);
+    }
+    template <typename Byte>
+    static constexpr quad_word load_block(const Byte* data, size_t count) noexcept
+    {
+        return load_block_helper(data, count, std::make_index_sequence<16>());
+    }
+public:
+    constexpr explicit aes_cmac(const aes_context<key_length>& context)
+        :_context(context)
+        ,_k1(subkey(context.encrypt(quad_word(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0))))
+        ,_k2(subkey(_k1))
+    {}
+    constexpr const quad_word& k1() const noexcept
+    {
+        return _k1;
+    }
+    constexpr const quad_word& k2() const noexcept
+    {
+        return _k2;
+    }
+    /// @return CMAC tag of size bytes starting at data
+    template <typename Byte>
+    constexpr quad_word mac(const Byte* data, size_t size) const
+    {
+        const size_t block_count = (size == 0) ? 1 : (size + 15) / 16;
+        const size_t last_offset = (block_count - 1) * 16;
+        std::array<uint8_t, 16> state{};
+        // all blocks but the last one need no padding and no subkey
+        for (size_t offset = 0; offset < last_offset; offset += 16) {
+            state = _context.encrypt(quad_word::from_array(state, std::make_index_sequence<16>())
+                                     .x_or(load_block(data + offset, 16))).to_array();
+        }
+        const size_t last_size = size - last_offset;
+        const quad_word last = (last_size == 16) ? load_block(data + last_offset, 16).x_or(_k1)
+                                                 : load_block(data + last_offset, last_size).x_or(_k2);
+        return _context.encrypt(quad_word::from_array(state, std::make_index_sequence<16>()).x_or(last));
+    }
+    template <typename Byte, size_t array_size>
+    constexpr quad_word mac(const std::array<Byte, array_size>& data) const
+    {
+        return this->mac(data.data(), array_size);
+    }
+    template <typename Byte, size_t array_size>
+    constexpr bool verify(const std::array<Byte, array_size>& data, const quad_word& tag) const
+    {
+        return this->mac(data) == tag;
+    }
+
+private:
+    const aes_context<key_length> _context;
+    const quad_word _k1;
+    const quad_word _k2;
+};
+
+/**
+    Key derivation in counter mode (NIST SP 800-108) with AES-CMAC as the PRF.
+    Fixed input data is [i]_32 || label || 0x00 || context || [L]_32.
+    @return output_size bytes of derived keying material
+*/
+template <size_t output_size, size_t key_length, typename Byte, size_t label_size, size_t context_size>
+constexpr std::array<uint8_t, output_size> derive_key(const aes_cmac<key_length>& prf,
+                                                      const std::array<Byte, label_size>& label,
+                                                      const std::array<Byte, context_size>& context)
+{
+    static_assert(output_size > 0, "");
+    constexpr size_t input_size = 4 + label_size + 1 + context_size + 4;
+    constexpr uint32_t output_bits = static_cast<uint32_t>(output_size * 8);
+    std::array<uint8_t, input_size> input{};
+    for (size_t i = 0; i < label_size; ++i)
+        input[4 + i] = static_cast<uint8_t>(label[i]);
+    for (size_t i = 0; i < context_size; ++i)
+        input[5 + label_size + i] = static_cast<uint8_t>(context[i]);
+    for (size_t i = 0; i < 4; ++i)
+        input[input_size - 4 + i] = static_cast<uint8_t>(output_bits >> (24 - 8 * i));
+
+    std::array<uint8_t, output_size> result{};
+    for (uint32_t counter = 1; (counter - 1) * 16 < output_size; ++counter) {
+        for (size_t i = 0; i < 4; ++i)
+            input[i] = static_cast<uint8_t>(counter >> (24 - 8 * i));
+        const auto block = prf.mac(input).to_array();
+        for (size_t i = 0; i < 16 && (counter - 1) * 16 + i < output_size; ++i)
+            result[(counter - 1) * 16 + i] = block[i];
+    }
+    return result;
+}
+}
@@ -30,15 +30,33 @@ public:
     {
         return L_table[b];
     }
-    static constexpr uint8_t multiply_galois(uint8_t b1, uint8_t b2){
-        uint16_t res = L_table[b1] + L_table[b2];
-        if( b1 == 0x01 ) return b2;
-        if( b2 == 0x01 ) return b1;
-        if( b1 == 0x00 || b2 == 0x00 ) return 0x00;
-        if( res > 0xFF ){
-            res -= 0xFF;
+    /// @return b multiplied by x (0x02) in GF(2^8)
+    static constexpr uint8_t xtime(const uint8_t b) noexcept
+    {
+        return static_cast<uint8_t>((b << 1) ^ ((b >> 7) * 0x1B));
+    }
+    /// @return b multiplied by a compile time constant, unrolled into a chain of xtime
+    template <uint8_t factor>
+    static constexpr uint8_t multiply(const uint8_t b) noexcept
+    {
+        if constexpr (factor == 0) {
+            (void)b;
+            return 0x00;
+        } else if constexpr (factor == 1) {
+            return b;
+        } else {
+            return static_cast<uint8_t>(((factor & 0x01) ? b : 0x00) ^ multiply<(factor >> 1)>(xtime(b)));
+        }
+    }
+    static constexpr uint8_t multiply_galois(uint8_t b1, uint8_t b2) noexcept
+    {
+        uint8_t res = 0x00;
+        for (size_t bit = 0; bit < 8; ++bit) {
+            res ^= static_cast<uint8_t>(-(b2 & 0x01) & b1);
+            b1 = xtime(b1);
+            b2 >>= 1;
         }
-        return E_table[static_cast<uint8_t>(res)];
+        return res;
     }
 
 private:
@@ -110,25 +128,6 @@ private:
         0x44, 0x11, 0x92, 0xD9, 0x23, 0x20, 0x2E, 0x89, 0xB4, 0x7C, 0xB8, 0x26, 0x77, 0x99, 0xE3, 0xA5,
         0x67, 0x4A, 0xED, 0xDE, 0xC5, 0x31, 0xFE, 0x18, 0x0D, 0x63, 0x8C, 0x80, 0xC0, 0xF7, 0x70, 0x07
     };
-
-    static inline constexpr uint8_t E_table[] = {
-        0x01, 0x03, 0x05, 0x0F, 0x11, 0x33, 0x55, 0xFF, 0x1A, 0x2E, 0x72, 0x96, 0xA1, 0xF8, 0x13, 0x35,
-        0x5F, 0xE1, 0x38, 0x48, 0xD8, 0x73, 0x95, 0xA4, 0xF7, 0x02, 0x06, 0x0A, 0x1E, 0x22, 0x66, 0xAA,
-        0xE5, 0x34, 0x5C, 0xE4, 0x37, 0x59, 0xEB, 0x26, 0x6A, 0xBE, 0xD9, 0x70, 0x90, 0xAB, 0xE6, 0x31,
-        0x53, 0xF5, 0x04, 0x0C, 0x14, 0x3C, 0x44, 0xCC, 0x4F, 0xD1, 0x68, 0xB8, 0xD3, 0x6E, 0xB2, 0xCD,
-        0x4C, 0xD4, 0x67, 0xA9, 0xE0, 0x3B, 0x4D, 0xD7, 0x62, 0xA6, 0xF1, 0x08, 0x18, 0x28, 0x78, 0x88,
-        0x83, 0x9E, 0xB9, 0xD0, 0x6B, 0xBD, 0xDC, 0x7F, 0x81, 0x98, 0xB3, 0xCE, 0x49, 0xDB, 0x76, 0x9A,
-        0xB5, 0xC4, 0x57, 0xF9, 0x10, 0x30, 0x50, 0xF0, 0x0B, 0x1D, 0x27, 0x69, 0xBB, 0xD6, 0x61, 0xA3,
-        0xFE, 0x19, 0x2B, 0x7D, 0x87, 0x92, 0xAD, 0xEC, 0x2F, 0x71, 0x93, 0xAE, 0xE9, 0x20, 0x60, 0xA0,
-        0xFB, 0x16, 0x3A, 0x4E, 0xD2, 0x6D, 0xB7, 0xC2, 0x5D, 0xE7, 0x32, 0x56, 0xFA, 0x15, 0x3F, 0x41,
-        0xC3, 0x5E, 0xE2, 0x3D, 0x47, 0xC9, 0x40, 0xC0, 0x5B, 0xED, 0x2C, 0x74, 0x9C, 0xBF, 0xDA, 0x75,
-        0x9F, 0xBA, 0xD5, 0x64, 0xAC, 0xEF, 0x2A, 0x7E, 0x82, 0x9D, 0xBC, 0xDF, 0x7A, 0x8E, 0x89, 0x80,
-        0x9B, 0xB6, 0xC1, 0x58, 0xE8, 0x23, 0x65, 0xAF, 0xEA, 0x25, 0x6F, 0xB1, 0xC8, 0x43, 0xC5, 0x54,
-        0xFC, 0x1F, 0x21, 0x63, 0xA5, 0xF4, 0x07, 0x09, 0x1B, 0x2D, 0x77, 0x99, 0xB0, 0xCB, 0x46, 0xCA,
-        0x45, 0xCF, 0x4A, 0xDE, 0x79, 0x8B, 0x86, 0x91, 0xA8, 0xE3, 0x3E, 0x42, 0xC6, 0x51, 0xF3, 0x0E,
-        0x12, 0x36, 0x5A, 0xEE, 0x29, 0x7B, 0x8D, 0x8C, 0x8F, 0x8A, 0x85, 0x94, 0xA7, 0xF2, 0x0D, 0x17,
-        0x39, 0x4B, 0xDD, 0x7C, 0x84, 0x97, 0xA2, 0xFD, 0x1C, 0x24, 0x6C, 0xB4, 0xC7, 0x52, 0xF6, 0x01
-    };
 };
 
 class rcon_table {
@@ -364,12 +363,29 @@ private:
     {
         return quad_word(s_box::value(data[index_seq]) ...);
     }
-    static constexpr uint8_t col_mix_helper(const quad_word& data, size_t column, uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    /// @return byte of the mixed column at index = row + 4 * column
+    static constexpr uint8_t column_mix_helper(const quad_word& data, size_t index) noexcept
+    {
+        const size_t row = index % 4;
+        const size_t column = index - row;
+        return s_box::multiply<0x2>(data[column + row])
+                ^ s_box::multiply<0x3>(data[column + (row + 1) % 4])
+                ^ data[column + (row + 2) % 4]
+                ^ data[column + (row + 3) % 4];
+    }
+    template <size_t ... index_seq>
+    static constexpr quad_word column_mix_helper(const quad_word& data, std::index_sequence<index_seq...>) noexcept
+    {
+        return quad_word(column_mix_helper(data, index_seq) ...);
+    }
+    /// @return 32-bit lanes of x rotated so that each byte receives the next row of its column
+    static constexpr uint64_t next_row(const uint64_t x) noexcept
     {
-        return s_box::multiply_galois(a, data(0, column))
-                ^ s_box::multiply_galois(b, data(1, column))
-                ^ s_box::multiply_galois(c, data(2, column))
-                ^ s_box::multiply_galois(d, data(3, column));
+        return ((x >> 8) & 0x00FFFFFF00FFFFFFull) | ((x << 24) & 0xFF000000FF000000ull);
+    }
+    static constexpr uint64_t xtime(const uint64_t x) noexcept
+    {
+        return ((x & 0x7F7F7F7F7F7F7F7Full) << 1) ^ (((x >> 7) & 0x0101010101010101ull) * 0x1B);
     }
     template <size_t index>
     constexpr quad_word encrypt_loop(const quad_word& data) const
@@ -390,16 +406,9 @@ private:
     {
         return substitute_helper(data, std::make_index_sequence<16>());
     }
-    static constexpr quad_word column_mix(const quad_word& data, size_t column) noexcept
-    {
-        return data.set(0, column, col_mix_helper(data, column, 0x2, 0x3, 0x1, 0x1))
-            .set(1, column, col_mix_helper(data, column, 0x1, 0x2, 0x3, 0x1))
-            .set(2, column, col_mix_helper(data, column, 0x1, 0x1, 0x2, 0x3))
-            .set(3, column, col_mix_helper(data, column, 0x3, 0x1, 0x1, 0x2));
-    }
     static constexpr quad_word column_mix(const quad_word &data) noexcept
     {
-        return column_mix(column_mix(column_mix(column_mix(data, 0), 1), 2), 3);
+        return column_mix_helper(data, std::make_index_sequence<16>());
     }
     static constexpr quad_word row_shift(const quad_word& data) noexcept
     {
@@ -433,8 +442,60 @@ public:
     {
         return this->encrypt_array_helper<Byte, array_size, array_size, 0>(data);
     }
+    /**
+        Runtime encryption of 4 consecutive blocks in place (ECB), the mix columns step runs on all of them at once.
+    */
+    void encrypt_x4(uint8_t* blocks) const noexcept
+    {
+        add_round_key_x4(blocks, 0);
+        for (size_t round = 1; round < number_of_rounds(); ++round) {
+            substitute_shift_x4(blocks);
+            column_mix_x4(blocks);
+            add_round_key_x4(blocks, round);
+        }
+        substitute_shift_x4(blocks);
+        add_round_key_x4(blocks, number_of_rounds());
+    }
+    /**
+        Runtime mix columns step applied in place to 4 consecutive blocks.
+        Two columns are processed per 64-bit word, eight words per call.
+    */
+    static void column_mix_x4(uint8_t* blocks) noexcept
+    {
+        for (size_t offset = 0; offset < 64; offset += 8) {
+            uint64_t a = 0;
+            for (size_t i = 0; i < 8; ++i)
+                a |= static_cast<uint64_t>(blocks[offset + i]) << (8 * i);
+            const uint64_t a1 = next_row(a);
+            const uint64_t a2 = next_row(a1);
+            const uint64_t a3 = next_row(a2);
+            const uint64_t b = xtime(a ^ a1) ^ a1 ^ a2 ^ a3;
+            for (size_t i = 0; i < 8; ++i)
+                blocks[offset + i] = static_cast<uint8_t>(b >> (8 * i));
+        }
+    }
 
 private:
+    /// s_box_replace and row_shift of 4 consecutive blocks, byte index = row + 4 * column
+    static void substitute_shift_x4(uint8_t* blocks) noexcept
+    {
+        for (size_t offset = 0; offset < 64; offset += 16) {
+            uint8_t state[16];
+            for (size_t i = 0; i < 16; ++i) {
+                const size_t row = i % 4;
+                state[i] = s_box::value(blocks[offset + (i + 4 * row) % 16]);
+            }
+            for (size_t i = 0; i < 16; ++i)
+                blocks[offset + i] = state[i];
+        }
+    }
+    void add_round_key_x4(uint8_t* blocks, size_t round_number) const noexcept
+    {
+        const quad_word round_key = this->_key.get_q_word(round_number * 16);
+        for (size_t i = 0; i < 64; ++i)
+            blocks[i] ^= round_key[i % 16];
+    }
+
     const aes_key<key_length> _key;
 };
 }
@@ -0,0 +1,138 @@
+#include "aes_utils/aes_utils.hpp"
+#include "aes_utils/aes_cmac.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define AES_BENCHMARK_HAS_TSC
+#endif
+
+/**
+    Runtime throughput of aes_utils, results are printed to stdout as a JSON array.
+    usage: aes_benchmark [min_size [max_size]], min_size > 0
+*/
+
+namespace {
+
+struct result {
+    std::string mode;
+    size_t key_bits;
+    std::string backend;
+    size_t bytes;
+    size_t iterations;
+    double seconds;
+    double cycles;
+};
+
+static uint64_t read_cycles()
+{
+#ifdef AES_BENCHMARK_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// prevents the compiler from removing the benchmarked code
+static volatile uint8_t sink;
+
+template <typename Function>
+static result measure(const std::string& mode, size_t key_bits, const std::string& backend, size_t bytes, Function&& function)
+{
+    using clock = std::chrono::steady_clock;
+    constexpr double min_seconds = 0.2;
+    size_t iterations = 0;
+    double seconds = 0.0;
+    uint64_t cycles = 0;
+    const auto start = clock::now();
+    const uint64_t start_cycles = read_cycles();
+    do {
+        function();
+        ++iterations;
+        seconds = std::chrono::duration<double>(clock::now() - start).count();
+    } while (seconds < min_seconds);
+    cycles = read_cycles() - start_cycles;
+    return result{mode, key_bits, backend, bytes, iterations, seconds, static_cast<double>(cycles)};
+}
+
+static void print(std::ostream& out, const result& r, bool last)
+{
+    const double total_bytes = static_cast<double>(r.bytes) * static_cast<double>(r.iterations);
+    out << "  {\"mode\": \"" << r.mode << "\", \"key_bits\": " << r.key_bits
+        << ", \"backend\": \"" << r.backend << "\", \"bytes\": " << r.bytes
+        << ", \"iterations\": " << r.iterations << ", \"seconds\": " << r.seconds
+        << ", \"gb_per_s\": " << total_bytes / r.seconds / 1e9 << ", \"cycles_per_byte\": ";
+#ifdef AES_BENCHMARK_HAS_TSC
+    out << r.cycles / total_bytes;
+#else
+    out << "null";
+#endif
+    out << '}' << (last ? "\n" : ",\n");
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    size_t min_size = 16;
+    size_t max_size = 64 * 1024 * 1024;
+    if (argc > 1)
+        min_size = std::stoul(argv[1]);
+    if (argc > 2)
+        max_size = std::stoul(argv[2]);
+    // sizes grow by multiplying, zero would never advance
+    if (min_size == 0) {
+        std::cerr << "min_size has to be at least 1\n";
+        return 1;
+    }
+
+    constexpr unsigned char key_data[] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+    constexpr aes_utils::aes_context<128> context(aes_utils::aes_key<128>::create(key_data).expand());
+    constexpr aes_utils::aes_cmac<128> cmac(context);
+
+    std::vector<result> results;
+    for (size_t size = min_size; size <= max_size; size *= 4) {
+        std::vector<uint8_t> input(size);
+        for (size_t i = 0; i < size; ++i)
+            input[i] = static_cast<uint8_t>(i * 31 + 7);
+        std::vector<uint8_t> output(size);
+
+        results.push_back(measure("ecb", 128, "reference", size, [&]() {
+            std::array<uint8_t, 16> block;
+            for (size_t offset = 0; offset + 16 <= size; offset += 16) {
+                std::memcpy(block.data(), input.data() + offset, 16);
+                block = context.encrypt(aes_utils::quad_word::from_array(block, std::make_index_sequence<16>())).to_array();
+                std::memcpy(output.data() + offset, block.data(), 16);
+            }
+            sink = output[size - 1];
+        }));
+        // four blocks per call with a shared mix columns step, the tail below 64 bytes goes block by block
+        results.push_back(measure("ecb", 128, "swar_x4", size, [&]() {
+            std::memcpy(output.data(), input.data(), size);
+            size_t offset = 0;
+            for (; offset + 64 <= size; offset += 64)
+                context.encrypt_x4(output.data() + offset);
+            std::array<uint8_t, 16> block;
+            for (; offset + 16 <= size; offset += 16) {
+                std::memcpy(block.data(), output.data() + offset, 16);
+                block = context.encrypt(aes_utils::quad_word::from_array(block, std::make_index_sequence<16>())).to_array();
+                std::memcpy(output.data() + offset, block.data(), 16);
+            }
+            sink = output[size - 1];
+        }));
+        results.push_back(measure("cmac", 128, "reference", size, [&]() {
+            sink = cmac.mac(input.data(), size)[0];
+        }));
+        std::cerr << "done: " << size << " bytes\n";
+    }
+
+    std::cout << "[\n";
+    for (size_t i = 0; i < results.size(); ++i)
+        print(std::cout, results[i], i + 1 == results.size());
+    std::cout << "]\n";
+    return 0;
+}
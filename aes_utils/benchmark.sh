@@ -0,0 +1,8 @@
+#!/bin/bash
+# builds and runs the runtime AES benchmark, JSON results are written to aes_benchmark.json
+g++ -O2 -std=c++17 -I.. benchmark.cpp -Wall -o aes_benchmark
+if [[ $? -ne 0 ]]; then
+	echo "g++ build failed!"
+	exit 1
+fi
+./aes_benchmark "$@" > aes_benchmark.json
@@ -7,6 +7,7 @@
 #include "string_partition/array_converter.hpp"
 #if __cplusplus >= 201703L
 #include "aes_utils/aes_utils.hpp"
+#include "aes_utils/aes_cmac.hpp"
 #endif
 #include "sha1/sha1_utils.hpp"
 #include "optimized_index_sequence.hpp"
@@ -165,6 +166,35 @@ static void test_aes_utils() {
   }
   for (int i = 0; i < 256; ++i)
     assert(aes_utils::s_box::value(aes_utils::s_box::inverse(i)) == i);
+  static_assert(aes_utils::s_box::xtime(0x57) == 0xae, "");
+  static_assert(aes_utils::s_box::xtime(0xae) == 0x47, "");
+  static_assert(aes_utils::s_box::multiply_galois(0x57, 0x83) == 0xc1, "");
+  static_assert(aes_utils::s_box::multiply_galois(0x57, 0x13) == 0xfe, "");
+  static_assert(aes_utils::s_box::multiply_galois(0x00, 0x13) == 0x00, "");
+  static_assert(aes_utils::s_box::multiply<0x13>(0x57) == 0xfe, "");
+  for (int i = 0; i < 256; ++i) {
+    const auto b = static_cast<uint8_t>(i);
+    assert(aes_utils::s_box::multiply<0x2>(b) == aes_utils::s_box::multiply_galois(0x2, b));
+    assert(aes_utils::s_box::multiply<0x3>(b) == aes_utils::s_box::multiply_galois(0x3, b));
+    assert(aes_utils::s_box::multiply<0x9>(b) == aes_utils::s_box::multiply_galois(0x9, b));
+    assert(aes_utils::s_box::multiply<0xb>(b) == aes_utils::s_box::multiply_galois(0xb, b));
+    assert(aes_utils::s_box::multiply<0xd>(b) == aes_utils::s_box::multiply_galois(0xd, b));
+    assert(aes_utils::s_box::multiply<0xe>(b) == aes_utils::s_box::multiply_galois(0xe, b));
+  }
+  {
+    uint8_t columns[64] = {
+      0xdb, 0x13, 0x53, 0x45, 0xf2, 0x0a, 0x22, 0x5c, 0x01, 0x01, 0x01, 0x01, 0xc6, 0xc6, 0xc6, 0xc6,
+      0xd4, 0xd4, 0xd4, 0xd5, 0x2d, 0x26, 0x31, 0x4c, 0xdb, 0x13, 0x53, 0x45, 0xf2, 0x0a, 0x22, 0x5c,
+      0x01, 0x01, 0x01, 0x01, 0xc6, 0xc6, 0xc6, 0xc6, 0xd4, 0xd4, 0xd4, 0xd5, 0x2d, 0x26, 0x31, 0x4c,
+      0xdb, 0x13, 0x53, 0x45, 0xf2, 0x0a, 0x22, 0x5c, 0x01, 0x01, 0x01, 0x01, 0xc6, 0xc6, 0xc6, 0xc6 };
+    const uint8_t mixed[64] = {
+      0x8e, 0x4d, 0xa1, 0xbc, 0x9f, 0xdc, 0x58, 0x9d, 0x01, 0x01, 0x01, 0x01, 0xc6, 0xc6, 0xc6, 0xc6,
+      0xd5, 0xd5, 0xd7, 0xd6, 0x4d, 0x7e, 0xbd, 0xf8, 0x8e, 0x4d, 0xa1, 0xbc, 0x9f, 0xdc, 0x58, 0x9d,
+      0x01, 0x01, 0x01, 0x01, 0xc6, 0xc6, 0xc6, 0xc6, 0xd5, 0xd5, 0xd7, 0xd6, 0x4d, 0x7e, 0xbd, 0xf8,
+      0x8e, 0x4d, 0xa1, 0xbc, 0x9f, 0xdc, 0x58, 0x9d, 0x01, 0x01, 0x01, 0x01, 0xc6, 0xc6, 0xc6, 0xc6 };
+    aes_utils::aes_context<128>::column_mix_x4(columns);
+    assert(std::equal(std::begin(columns), std::end(columns), std::begin(mixed)));
+  }
   static_assert(
       aes_utils::s_box::value(aes_utils::s_box::inverse(0x4f)) == 0x4f, "");
   static_assert(aes_utils::s_box::value(0xc9) == 0xdd, "");
@@ -219,11 +249,72 @@ static void test_aes_utils() {
   constexpr aes_utils::aes_context<128> ctx(key_test.expand());
   constexpr auto result = ctx.encrypt(plaintext2);
   static_assert(array_converter::is_equal(result, expected2), "");
+
+  // four blocks at once at runtime, against the constexpr single block path
+  uint8_t blocks[64];
+  for (size_t i = 0; i < 64; ++i)
+    blocks[i] = static_cast<uint8_t>(i < 32 ? plaintext2[i] : i * 37 + 11);
+  std::array<unsigned char, 64> expected4;
+  for (size_t offset = 0; offset < 64; offset += 16) {
+    std::array<unsigned char, 16> block;
+    std::copy(blocks + offset, blocks + offset + 16, block.begin());
+    const auto encrypted = ctx.encrypt(block);
+    std::copy(encrypted.begin(), encrypted.end(), expected4.begin() + offset);
+  }
+  ctx.encrypt_x4(blocks);
+  assert(std::equal(std::begin(blocks), std::end(blocks), expected4.begin()));
+  assert(std::equal(expected2.begin(), expected2.end(), std::begin(blocks)));
   }
 
 #endif
 }
 
+static void test_aes_cmac() {
+#if __cplusplus >= 201703L
+  // test vectors from RFC 4493
+  constexpr unsigned char key[] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+  constexpr aes_utils::aes_context<128> ctx(aes_utils::aes_key<128>::create(key).expand());
+  constexpr aes_utils::aes_cmac<128> cmac(ctx);
+  static_assert(cmac.k1() == aes_utils::quad_word{0xfb, 0xee, 0xd6, 0x18, 0x35, 0x71, 0x33, 0x66,
+                                                  0x7c, 0x85, 0xe0, 0x8f, 0x72, 0x36, 0xa8, 0xde}, "");
+  static_assert(cmac.k2() == aes_utils::quad_word{0xf7, 0xdd, 0xac, 0x30, 0x6a, 0xe2, 0x66, 0xcc,
+                                                  0xf9, 0x0b, 0xc1, 0x1e, 0xe4, 0x6d, 0x51, 0x3b}, "");
+  constexpr std::array<unsigned char, 0> empty{};
+  static_assert(cmac.mac(empty) == aes_utils::quad_word{0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28,
+                                                        0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46}, "");
+  constexpr std::array<unsigned char, 64> message = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10 };
+  static_assert(cmac.mac(message.data(), 16) == aes_utils::quad_word{0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44,
+                                                                     0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c}, "");
+  static_assert(cmac.mac(message.data(), 40) == aes_utils::quad_word{0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30,
+                                                                     0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27}, "");
+  constexpr aes_utils::quad_word tag64{0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92,
+                                       0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe};
+  static_assert(cmac.verify(message, tag64), "");
+  // runtime path
+  std::array<unsigned char, 64> runtime_message = message;
+  assert(cmac.mac(runtime_message) == tag64);
+  runtime_message[63] ^= 0x1;
+  assert(!cmac.verify(runtime_message, tag64));
+
+  // SP 800-108 counter mode KDF
+  constexpr std::array<char, 5> label = {'l', 'a', 'b', 'e', 'l'};
+  constexpr std::array<char, 7> context = {'c', 'o', 'n', 't', 'e', 'x', 't'};
+  constexpr auto derived = aes_utils::derive_key<32>(cmac, label, context);
+  constexpr std::array<uint8_t, 32> expected_derived = {
+    0xc7, 0x85, 0x18, 0x7c, 0x26, 0x66, 0xa4, 0xd2, 0x0a, 0x8b, 0x7a, 0x23, 0xf5, 0x7b, 0x5e, 0x32,
+    0x97, 0xc4, 0x4e, 0x11, 0x3d, 0xb9, 0x6d, 0x84, 0x6d, 0x52, 0x42, 0x2c, 0x73, 0xc5, 0x10, 0x3f };
+  static_assert(array_converter::is_equal(derived, expected_derived), "");
+  constexpr std::array<uint8_t, 20> expected_derived_short = {
+    0x94, 0x51, 0xf9, 0xf8, 0x81, 0x5d, 0x5a, 0xe4, 0xcf, 0xb5, 0xc2, 0x7e, 0x94, 0xff, 0x50, 0x20,
+    0x3d, 0x40, 0x2e, 0x07 };
+  assert(array_converter::is_equal(aes_utils::derive_key<20>(cmac, label, context), expected_derived_short));
+#endif
+}
+
 /**
     /// @TODO structure the tests somehow, cmake maybe
 */
@@ -440,6 +531,7 @@ int main() {
   test_partition();
   test_partition_transform();
   test_aes_utils();
+  test_aes_cmac();
   test_sha1_utils();
   test_index_sequences();
   testMultiIterate();
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "KeyIndex.h"
 #include "StringUtils.h"
+#include "Tokenizer.h"
 #include "TypeListUtils.h"
 #include <string>
 #include <type_traits>
 #include <array>
+#include <limits>
+#include <utility>
 
 ///
 /// Utilities for compile-time parsing of JSON
@@ -31,64 +35,20 @@ namespace ctjson
         using Rest = typename Ops::template right<tokenLength - 1>;
     };
 
-    enum class TokenType : uint8_t {
-        String,
-        Number,
-        Boolean,
-        Null,
-        DictOpen,
-        DictClose,
-        ArrayOpen,
-        ArrayClose,
-        Colon,
-        Comma,
-        Invalid
-    };
-
     template <typename InputString>
     class ReadToken {
-        static constexpr bool isNumber(char c) noexcept
-        {
-            return c >= '0' && c <= '9';
-        }
-
     private:
         using Input = typename InputString::Trimmed;
 
         static constexpr std::pair<TokenType, size_t> nextTokenSpecs() noexcept
         {
-            if constexpr (Input::at(0) == '{' || Input::at(0) == '}') {
-                return { (Input::at(0) == '{' ? TokenType::DictOpen : TokenType::DictClose), 1 };
-            }
-            else if constexpr (Input::at(0) == '[' || Input::at(0) == ']') {
-                return { (Input::at(0) == '[' ? TokenType::ArrayOpen : TokenType::ArrayClose), 1 };
-            }
-            else if constexpr (Input::at(0) == ':') {
-                return { TokenType::Colon, 1 };
-            }
-            else if constexpr (Input::at(0) == ',') {
-                return { TokenType::Comma, 1 };
-            }
-            else if constexpr (Input::at(0) == '"') {
-                constexpr auto pos{ Input::find("\"", 1) };
-                return { (pos != std::string::npos) ? TokenType::String : TokenType::Invalid, (pos != std::string::npos) ? pos + 1 : 0 };
-            }
-            else if constexpr (isNumber(Input::at(0))) {
-                for (size_t i = 1; i < Input::size(); ++i) {
-                    //TODO support float literals
-                    if (!isNumber(Input::at(i))) {
-                        return { TokenType::Number, i };
-                    }
-                }
-                return { TokenType::Number, Input::size() };
-            }
-            else if constexpr ((Input::find("true") == 0) || (Input::find("false") == 0)) {
-                return { TokenType::Boolean, 4 };
+            if constexpr (Input::size() == 0) {
+                return { TokenType::Invalid, 0 };
+            } else {
+                constexpr auto input{ Input::asStringView() };
+                constexpr JSONToken token{ classifyToken(input.data(), input.size(), 0) };
+                return { token.type, token.length };
             }
-            else if constexpr (Input::find("null") == 0) {
-                return { TokenType::Null, 4 };
-            }
-            return { TokenType::Invalid, 0 };
         }
 
         static constexpr auto tokenSpec{ nextTokenSpecs() };
@@ -100,27 +60,42 @@ namespace ctjson
         static constexpr TokenType type{ tokenSpec.first };
     };
 
-    template <typename InputString, bool is_empty = (InputString::size() == 0)>
+    ///
+    /// All tokens of the input, computed once by the constexpr tokenizer
+    ///
+    template <typename InputString>
+    class JSONTokenArray {
+        static constexpr StringView input{ InputString::asStringView() };
+
+    public:
+        static constexpr size_t count{ countTokens(input.data(), input.size()) };
+        static constexpr std::array<JSONToken, count> tokens{ tokenize<count>(input.data(), input.size()) };
+    };
+
+    ///
+    /// Type level cursor over JSONTokenArray, used by the parser
+    ///
+    template <typename InputString, size_t index = 0, bool at_end = (index >= JSONTokenArray<InputString>::count)>
     class JSONTokenizer;
 
-    template <typename InputString>
-    class JSONTokenizer<InputString, false> {
-        using Tokenizer = ReadToken<InputString>;
+    template <typename InputString, size_t index>
+    class JSONTokenizer<InputString, index, false> {
+        static constexpr JSONToken token{ JSONTokenArray<InputString>::tokens[index] };
 
     public:
-        using Token = typename Tokenizer::Token;
-        using Next = JSONTokenizer<typename Tokenizer::Rest>;
-        static constexpr TokenType type{ Tokenizer::type };
+        using Input = InputString;
+        using Token = typename InputString::template Substring<token.offset, token.offset + token.length>;
+        using Next = JSONTokenizer<InputString, index + 1>;
+        static constexpr TokenType type{ token.type };
+        static constexpr size_t offset{ token.offset };
+        static constexpr size_t position{ index };
 
         template <size_t idx>
-        using At = std::conditional_t < idx == 0,
-            JSONTokenizer<InputString>,
-            typename Next::template At<idx - 1>
-        >;
+        using At = JSONTokenizer<InputString, index + idx>;
     };
 
-    template <typename InputString>
-    class JSONTokenizer<InputString, true> {
+    template <typename InputString, size_t index>
+    class JSONTokenizer<InputString, index, true> {
     public:
         using Token = std::false_type;
         using Next = std::false_type;
@@ -142,6 +117,17 @@ namespace ctjson
         static constexpr auto type = TokenType::Invalid;
     };
 
+    namespace priv
+    {
+        /// true if every value of From is represented exactly by To (integer widening, integer to floating point)
+        template <typename From, typename To>
+        constexpr bool isLosslessConversion {
+            !std::is_same_v<From, bool> && !std::is_same_v<To, bool> && std::is_integral_v<From> &&
+            ((std::is_integral_v<To> && std::is_signed_v<From> == std::is_signed_v<To> && sizeof(To) >= sizeof(From)) ||
+             (std::is_floating_point_v<To> && std::numeric_limits<From>::digits <= std::numeric_limits<To>::digits))
+        };
+    } // namespace priv
+
     template <typename T>
     class JSONValueWrapper
     {
@@ -156,9 +142,10 @@ namespace ctjson
 
         }
 
-        //TODO allow some conversions
+        /// lossless conversions keep the value, any other type gives the default value
         template <typename U>
         constexpr explicit JSONValueWrapper(const U &val) noexcept
+            : value_ {convert(val)}
         {
 
         }
@@ -172,9 +159,161 @@ namespace ctjson
             return value_;
         }
     private:
+        template <typename U>
+        static constexpr T convert(const U &val) noexcept
+        {
+            if constexpr (priv::isLosslessConversion<U, T>) {
+                return static_cast<T>(val);
+            } else {
+                return T {};
+            }
+        }
+
         const T value_ = {};
     };
 
+    namespace priv
+    {
+        /// @return value of a scalar token if it has type T, default value otherwise; integers have to be in the range of T
+        template <typename T>
+        constexpr JSONValueWrapper<T> tokenValue(TokenType type, const char *str, size_t length) noexcept
+        {
+            const bool integer {type == TokenType::Number && isIntegerNumber(str, length)};
+            const IntegerRange range {integer ? integerRange(str, length) : IntegerRange::Overflow};
+            if constexpr (std::is_same_v<T, bool>) {
+                return (type == TokenType::Boolean) ? JSONValueWrapper<T>(length == 4) : JSONValueWrapper<T>();
+            } else if constexpr (std::is_same_v<T, int32_t>) {
+                return (range == IntegerRange::Int32) ? JSONValueWrapper<T>(static_cast<T>(parseInt64(str, length))) : JSONValueWrapper<T>();
+            } else if constexpr (std::is_same_v<T, int64_t>) {
+                return (range == IntegerRange::Int32 || range == IntegerRange::Int64) ? JSONValueWrapper<T>(parseInt64(str, length)) : JSONValueWrapper<T>();
+            } else if constexpr (std::is_same_v<T, uint64_t>) {
+                return (range != IntegerRange::Overflow && str[0] != '-') ? JSONValueWrapper<T>(parseUInt64(str, length)) : JSONValueWrapper<T>();
+            } else if constexpr (std::is_same_v<T, double>) {
+                return (type == TokenType::Number && !integer) ? JSONValueWrapper<T>(parseDouble(str, length)) : JSONValueWrapper<T>();
+            } else if constexpr (std::is_same_v<T, StringView>) {
+                return (type == TokenType::String) ? JSONValueWrapper<T>(StringView(str, length)) : JSONValueWrapper<T>();
+            } else {
+                return JSONValueWrapper<T>();
+            }
+        }
+    } // namespace priv
+
+    ///
+    /// Copy of a scalar value (number, boolean or string) of an object tree,
+    /// other values are recorded without their contents
+    ///
+    class JSONScalar
+    {
+        enum class Kind : uint8_t {
+            None,
+            Integer,
+            /// integers above the int64_t range
+            Unsigned,
+            Number,
+            Boolean,
+            String
+        };
+
+    public:
+        template <typename T>
+        static constexpr bool holds {std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> || std::is_same_v<T, double> || std::is_same_v<T, bool>
+            || std::is_same_v<T, StringView>};
+
+        constexpr JSONScalar() noexcept = default;
+
+        template <typename T>
+        static constexpr JSONScalar of(const T &value) noexcept
+        {
+            JSONScalar result;
+            if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>) {
+                result.kind_ = Kind::Integer;
+                result.integer_ = value;
+            } else if constexpr (std::is_same_v<T, uint64_t>) {
+                const bool fits {value <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())};
+                result.kind_ = fits ? Kind::Integer : Kind::Unsigned;
+                result.integer_ = fits ? static_cast<int64_t>(value) : 0;
+                result.unsigned_ = fits ? 0 : value;
+            } else if constexpr (std::is_same_v<T, double>) {
+                result.kind_ = Kind::Number;
+                result.number_ = value;
+            } else if constexpr (std::is_same_v<T, bool>) {
+                result.kind_ = Kind::Boolean;
+                result.boolean_ = value;
+            } else if constexpr (std::is_same_v<T, StringView>) {
+                result.kind_ = Kind::String;
+                result.string_ = value;
+            }
+            return result;
+        }
+
+        /// @return true if the value has type T or converts to it without loss
+        template <typename T>
+        constexpr bool is() const noexcept
+        {
+            static_assert(holds<T>, "not a scalar type");
+            // integers beyond 2^53 are not exact as double
+            constexpr int64_t exactDouble {int64_t(1) << std::numeric_limits<double>::digits};
+            if constexpr (std::is_same_v<T, double>) {
+                return kind_ == Kind::Number || (kind_ == Kind::Integer && integer_ >= -exactDouble && integer_ <= exactDouble);
+            } else if constexpr (std::is_same_v<T, bool>) {
+                return kind_ == Kind::Boolean;
+            } else if constexpr (std::is_same_v<T, StringView>) {
+                return kind_ == Kind::String;
+            } else if constexpr (std::is_same_v<T, uint64_t>) {
+                return kind_ == Kind::Unsigned || (kind_ == Kind::Integer && integer_ >= 0);
+            } else if constexpr (std::is_same_v<T, int32_t>) {
+                return kind_ == Kind::Integer && integer_ >= std::numeric_limits<int32_t>::min() && integer_ <= std::numeric_limits<int32_t>::max();
+            } else {
+                return kind_ == Kind::Integer;
+            }
+        }
+
+        /// @return the value if it has type T or converts to it without loss, default value otherwise
+        template <typename T>
+        constexpr JSONValueWrapper<T> as() const noexcept
+        {
+            if (!is<T>()) {
+                return JSONValueWrapper<T>();
+            }
+            if constexpr (std::is_same_v<T, double>) {
+                return (kind_ == Kind::Number) ? JSONValueWrapper<T>(number_) : JSONValueWrapper<T>(static_cast<double>(integer_));
+            } else if constexpr (std::is_same_v<T, bool>) {
+                return JSONValueWrapper<T>(boolean_);
+            } else if constexpr (std::is_same_v<T, StringView>) {
+                return JSONValueWrapper<T>(string_);
+            } else if constexpr (std::is_same_v<T, uint64_t>) {
+                return JSONValueWrapper<T>((kind_ == Kind::Unsigned) ? unsigned_ : static_cast<uint64_t>(integer_));
+            } else {
+                return JSONValueWrapper<T>(static_cast<T>(integer_));
+            }
+        }
+
+    private:
+        Kind kind_ {Kind::None};
+        int64_t integer_ {0};
+        uint64_t unsigned_ {0};
+        double number_ {0.0};
+        bool boolean_ {false};
+        StringView string_ {};
+    };
+
+    namespace priv
+    {
+        /// @return value of an object tree entry as T, scalars convert by their value like JSONScalar::as
+        /// (e.g. 5 is a valid uint64_t, 5000000000 a valid double), other types only by type (isLosslessConversion)
+        template <typename T, typename U>
+        constexpr JSONValueWrapper<T> entryValue(const U &value) noexcept
+        {
+            if constexpr (std::is_same_v<U, JSONScalar> && JSONScalar::holds<T>) {
+                return value.template as<T>();
+            } else if constexpr (JSONScalar::holds<T> && JSONScalar::holds<U>) {
+                return JSONScalar::of(value).template as<T>();
+            } else {
+                return JSONValueWrapper<T>(value);
+            }
+        }
+    } // namespace priv
+
     template <typename Current>
     class JSONObjectLocator
     {
@@ -218,7 +357,7 @@ namespace ctjson
         template <typename T, size_t N>
         constexpr JSONValueWrapper<T> get(const char (&name)[N]) const noexcept
         {
-            return name_.equals(name) ? JSONValueWrapper<T>(value_) : JSONObjectLocator<Data>::template get<T>(value_, name);
+            return name_.equals(name) ? priv::entryValue<T>(value_) : JSONObjectLocator<Data>::template get<T>(value_, name);
         }
 
     private:
@@ -226,11 +365,14 @@ namespace ctjson
         const Data value_;
     };
 
+    ///
+    /// Entry of the key/value chain of a JSONDict, lookups walk the chain
+    ///
     template <typename Data, typename Next>
-    class JSONDict
+    class JSONDictNode
     {
     public:
-        constexpr explicit JSONDict(const Data &data, const Next &next) noexcept :
+        constexpr explicit JSONDictNode(const Data &data, const Next &next) noexcept :
             data_ {data},
             next_ {next}
         {}
@@ -261,6 +403,103 @@ namespace ctjson
         const Next next_;
     };
 
+    ///
+    /// Enumerates the names and values of an object tree in lookup order (depth first, parents before children)
+    /// and fetches values by their position in that order
+    ///
+    template <typename Current>
+    class JSONKeys
+    {
+    public:
+        static constexpr size_t count {0};
+
+        static constexpr void collectNames(const Current &, StringView *) noexcept
+        {
+        }
+
+        static constexpr void collectValues(const Current &, JSONScalar *) noexcept
+        {
+        }
+
+        template <typename V>
+        static constexpr JSONValueWrapper<V> get(const Current &, size_t) noexcept
+        {
+            return JSONValueWrapper<V>();
+        }
+    };
+
+    ///
+    /// JSON object with two or more entries,
+    /// lookups go through a perfect hash of all names in the object tree
+    /// and scalar values are read from a flat copy instead of walking the entries
+    ///
+    template <typename Data, typename Next>
+    class JSONDict
+    {
+        using Entries = JSONDictNode<Data, Next>;
+        using Keys = JSONKeys<Entries>;
+
+        static constexpr std::array<StringView, Keys::count> collectNames(const Entries &entries) noexcept
+        {
+            std::array<StringView, Keys::count> names {};
+            Keys::collectNames(entries, names.data());
+            return names;
+        }
+
+        static constexpr std::array<JSONScalar, Keys::count> collectValues(const Entries &entries) noexcept
+        {
+            std::array<JSONScalar, Keys::count> values {};
+            Keys::collectValues(entries, values.data());
+            return values;
+        }
+
+    public:
+        constexpr explicit JSONDict(const Data &data, const Next &next) noexcept :
+            entries_ {data, next},
+            index_ {collectNames(entries_)},
+            values_ {collectValues(entries_)}
+        {}
+        constexpr const Entries &entries() const noexcept
+        {
+            return entries_;
+        }
+        constexpr const Data &node() const noexcept
+        {
+            return entries_.node();
+        }
+        constexpr const Next &next() const noexcept
+        {
+            return entries_.next();
+        }
+
+        template <size_t N>
+        constexpr bool contains(const char (&name)[N]) const noexcept
+        {
+            return index_.valid() ? (index_.find(name) != index_.npos) : entries_.contains(name);
+        }
+
+        template <typename T, size_t N>
+        constexpr JSONValueWrapper<T> get(const char (&name)[N]) const noexcept
+        {
+            if (!index_.valid()) {
+                return entries_.template get<T>(name);
+            }
+            const size_t position {index_.find(name)};
+            if (position == index_.npos) {
+                return JSONValueWrapper<T>();
+            }
+            if constexpr (JSONScalar::holds<T>) {
+                return values_[position].template as<T>();
+            } else {
+                return Keys::template get<T>(entries_, position);
+            }
+        }
+    private:
+        const Entries entries_;
+        const JSONKeyIndex<Keys::count> index_;
+        const std::array<JSONScalar, Keys::count> values_;
+    };
+
     template <typename T>
     class JSONObjectLocator<JSONObject<T>>
     {
@@ -295,6 +534,551 @@ namespace ctjson
         }
     };
 
+    template <typename T, typename U>
+    class JSONObjectLocator<JSONDictNode<T, U>>
+    {
+    public:
+        template <size_t N>
+        static constexpr bool contains(const JSONDictNode<T, U> &obj, const char (&name)[N]) noexcept
+        {
+            return obj.contains(name);
+        }
+
+        template <typename V, size_t N>
+        static constexpr JSONValueWrapper<V> get(const JSONDictNode<T, U> &obj, const char (&name)[N]) noexcept
+        {
+            return obj.template get<V>(name);
+        }
+    };
+
+    template <typename T>
+    class JSONKeys<JSONObject<T>>
+    {
+        using ValueKeys = JSONKeys<T>;
+
+    public:
+        static constexpr size_t count {1 + ValueKeys::count};
+
+        static constexpr void collectNames(const JSONObject<T> &obj, StringView *names) noexcept
+        {
+            names[0] = obj.name();
+            ValueKeys::collectNames(obj.value(), names + 1);
+        }
+
+        static constexpr void collectValues(const JSONObject<T> &obj, JSONScalar *values) noexcept
+        {
+            values[0] = JSONScalar::of(obj.value());
+            ValueKeys::collectValues(obj.value(), values + 1);
+        }
+
+        template <typename V>
+        static constexpr JSONValueWrapper<V> get(const JSONObject<T> &obj, size_t position) noexcept
+        {
+            return (position == 0) ? priv::entryValue<V>(obj.value()) : ValueKeys::template get<V>(obj.value(), position - 1);
+        }
+    };
+
+    template <typename T, typename U>
+    class JSONKeys<JSONDictNode<T, U>>
+    {
+        using DataKeys = JSONKeys<T>;
+        using NextKeys = JSONKeys<U>;
+
+    public:
+        static constexpr size_t count {DataKeys::count + NextKeys::count};
+
+        static constexpr void collectNames(const JSONDictNode<T, U> &obj, StringView *names) noexcept
+        {
+            DataKeys::collectNames(obj.node(), names);
+            NextKeys::collectNames(obj.next(), names + DataKeys::count);
+        }
+
+        static constexpr void collectValues(const JSONDictNode<T, U> &obj, JSONScalar *values) noexcept
+        {
+            DataKeys::collectValues(obj.node(), values);
+            NextKeys::collectValues(obj.next(), values + DataKeys::count);
+        }
+
+        template <typename V>
+        static constexpr JSONValueWrapper<V> get(const JSONDictNode<T, U> &obj, size_t position) noexcept
+        {
+            return (position < DataKeys::count) ?
+                        DataKeys::template get<V>(obj.node(), position) :
+                        NextKeys::template get<V>(obj.next(), position - DataKeys::count);
+        }
+    };
+
+    template <typename T, typename U>
+    class JSONKeys<JSONDict<T, U>>
+    {
+        using EntryKeys = JSONKeys<JSONDictNode<T, U>>;
+
+    public:
+        static constexpr size_t count {EntryKeys::count};
+
+        static constexpr void collectNames(const JSONDict<T, U> &obj, StringView *names) noexcept
+        {
+            EntryKeys::collectNames(obj.entries(), names);
+        }
+
+        static constexpr void collectValues(const JSONDict<T, U> &obj, JSONScalar *values) noexcept
+        {
+            EntryKeys::collectValues(obj.entries(), values);
+        }
+
+        template <typename V>
+        static constexpr JSONValueWrapper<V> get(const JSONDict<T, U> &obj, size_t position) noexcept
+        {
+            return EntryKeys::template get<V>(obj.entries(), position);
+        }
+    };
+
+    namespace priv
+    {
+        /// element type of an array, over all nesting levels
+        enum class JSONLeafKind : uint8_t {
+            None,
+            Integer,
+            Number,
+            Boolean,
+            String,
+            Null,
+            Mixed,
+            Object,
+            Integer64,
+            Unsigned64,
+            /// integer which fits no integer type
+            Overflow
+        };
+
+        constexpr JSONLeafKind integerLeafKind(IntegerRange range) noexcept
+        {
+            switch (range) {
+            case IntegerRange::Int32:
+                return JSONLeafKind::Integer;
+            case IntegerRange::Int64:
+                return JSONLeafKind::Integer64;
+            case IntegerRange::UInt64:
+                return JSONLeafKind::Unsigned64;
+            default:
+                return JSONLeafKind::Overflow;
+            }
+        }
+
+        constexpr JSONLeafKind combineKinds(JSONLeafKind a, JSONLeafKind b) noexcept
+        {
+            if (a == JSONLeafKind::None || a == b) {
+                return b;
+            }
+            if (b == JSONLeafKind::None) {
+                return a;
+            }
+            if (a == JSONLeafKind::Overflow || b == JSONLeafKind::Overflow) {
+                return JSONLeafKind::Overflow;
+            }
+            const bool integerA {a == JSONLeafKind::Integer || a == JSONLeafKind::Integer64 || a == JSONLeafKind::Unsigned64};
+            const bool integerB {b == JSONLeafKind::Integer || b == JSONLeafKind::Integer64 || b == JSONLeafKind::Unsigned64};
+            // integers of any width next to fractional numbers make a double array, beyond 2^53 they round like parseDouble
+            if ((integerA && b == JSONLeafKind::Number) || (a == JSONLeafKind::Number && integerB)) {
+                return JSONLeafKind::Number;
+            }
+            if (integerA && integerB) {
+                // unsigned as long as no integer is negative, see JSONArrayShape::negative
+                return (a == JSONLeafKind::Unsigned64 || b == JSONLeafKind::Unsigned64) ? JSONLeafKind::Unsigned64 : JSONLeafKind::Integer64;
+            }
+            return JSONLeafKind::Mixed;
+        }
+
+        constexpr JSONLeafKind leafKind(const JSONToken &token, const char *input) noexcept
+        {
+            switch (token.type) {
+            case TokenType::Number:
+                return isIntegerNumber(input + token.offset, token.length) ? integerLeafKind(integerRange(input + token.offset, token.length)) : JSONLeafKind::Number;
+            case TokenType::Boolean:
+                return JSONLeafKind::Boolean;
+            case TokenType::String:
+                return JSONLeafKind::String;
+            case TokenType::Null:
+                return JSONLeafKind::Null;
+            default:
+                return JSONLeafKind::None;
+            }
+        }
+
+        /// @return index of the token after the object opened at index, npos if it is malformed
+        constexpr size_t skipObject(const JSONToken *tokens, size_t count, size_t index) noexcept
+        {
+            size_t depth {0};
+            for (; index < count; ++index) {
+                const TokenType type {tokens[index].type};
+                if (type == TokenType::DictOpen || type == TokenType::ArrayOpen) {
+                    ++depth;
+                } else if (type == TokenType::DictClose || type == TokenType::ArrayClose) {
+                    if (--depth == 0) {
+                        return index + 1;
+                    }
+                } else if (type == TokenType::Invalid) {
+                    break;
+                }
+            }
+            return static_cast<size_t>(-1);
+        }
+
+        ///
+        /// Dimensions and element type of a possibly nested array,
+        /// rectangular if all arrays on one nesting level have the same length
+        ///
+        struct JSONArrayShape
+        {
+            static constexpr size_t maxDepth {8};
+
+            bool valid {false};
+            bool rectangular {true};
+            /// index of the token after the array
+            size_t end {0};
+            size_t depth {0};
+            size_t dims[maxDepth] {};
+            JSONLeafKind kind {JSONLeafKind::None};
+            /// some number is negative, so integers can not be stored as uint64_t
+            bool negative {false};
+            /// some element, on any nesting level, is an object
+            bool objects {false};
+        };
+
+        constexpr JSONArrayShape arrayShape(const JSONToken *tokens, size_t count, const char *input, size_t open) noexcept
+        {
+            JSONArrayShape shape;
+            if (open >= count || tokens[open].type != TokenType::ArrayOpen) {
+                return shape;
+            }
+            shape.depth = 1;
+            size_t index {open + 1};
+            if (index < count && tokens[index].type == TokenType::ArrayClose) {
+                shape.valid = true;
+                shape.end = index + 1;
+                return shape;
+            }
+            // shape of the first element, the other elements have to match it
+            JSONArrayShape row;
+            for (size_t length = 1; index < count; ++length) {
+                JSONArrayShape element;
+                const JSONToken &token {tokens[index]};
+                if (token.type == TokenType::ArrayOpen) {
+                    element = arrayShape(tokens, count, input, index);
+                    if (!element.valid || element.depth == JSONArrayShape::maxDepth) {
+                        return JSONArrayShape();
+                    }
+                    index = element.end;
+                } else if (token.type == TokenType::DictOpen) {
+                    index = skipObject(tokens, count, index);
+                    if (index == static_cast<size_t>(-1)) {
+                        return JSONArrayShape();
+                    }
+                    element.kind = JSONLeafKind::Object;
+                } else {
+                    element.kind = leafKind(token, input);
+                    element.negative = (token.type == TokenType::Number && input[token.offset] == '-');
+                    if (element.kind == JSONLeafKind::None) {
+                        return JSONArrayShape();
+                    }
+                    ++index;
+                }
+                if (length == 1) {
+                    row = element;
+                } else {
+                    bool same {row.depth == element.depth && element.rectangular};
+                    for (size_t i = 0; same && i < row.depth; ++i) {
+                        same = (row.dims[i] == element.dims[i]);
+                    }
+                    shape.rectangular = shape.rectangular && same;
+                }
+                shape.kind = combineKinds(shape.kind, element.kind);
+                shape.negative = shape.negative || element.negative;
+                shape.objects = shape.objects || element.objects || element.kind == JSONLeafKind::Object;
+                if (index >= count || (tokens[index].type != TokenType::Comma && tokens[index].type != TokenType::ArrayClose)) {
+                    return JSONArrayShape();
+                }
+                if (tokens[index++].type == TokenType::ArrayClose) {
+                    if (shape.kind == JSONLeafKind::Unsigned64 && shape.negative) {
+                        shape.kind = JSONLeafKind::Mixed;
+                    }
+                    shape.valid = true;
+                    shape.end = index;
+                    shape.rectangular = shape.rectangular && row.rectangular;
+                    shape.depth = 1 + row.depth;
+                    shape.dims[0] = length;
+                    for (size_t i = 0; i < row.depth; ++i) {
+                        shape.dims[i + 1] = row.dims[i];
+                    }
+                    return shape;
+                }
+            }
+            return JSONArrayShape();
+        }
+
+        /// @return token indices of the first count elements of the array opened at open
+        template <size_t count>
+        constexpr std::array<size_t, count> arrayElements(const JSONToken *tokens, size_t tokenCount, const char *input, size_t open) noexcept
+        {
+            std::array<size_t, count> elements {};
+            size_t index {open + 1};
+            for (size_t i = 0; i < count; ++i) {
+                elements[i] = index;
+                if (tokens[index].type == TokenType::ArrayOpen) {
+                    index = arrayShape(tokens, tokenCount, input, index).end;
+                } else if (tokens[index].type == TokenType::DictOpen) {
+                    index = skipObject(tokens, tokenCount, index);
+                } else {
+                    ++index;
+                }
+                ++index;
+            }
+            return elements;
+        }
+
+        template <typename T>
+        constexpr T leafValue(const JSONToken &token, const char *input) noexcept
+        {
+            const char *str {input + token.offset};
+            if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>) {
+                return static_cast<T>(parseInt64(str, token.length));
+            } else if constexpr (std::is_same_v<T, uint64_t>) {
+                return parseUInt64(str, token.length);
+            } else if constexpr (std::is_same_v<T, double>) {
+                return parseDouble(str, token.length);
+            } else if constexpr (std::is_same_v<T, bool>) {
+                return token.length == 4;
+            } else if constexpr (std::is_same_v<T, StringView>) {
+                return StringView(str, token.length);
+            } else {
+                switch (leafKind(token, input)) {
+                case JSONLeafKind::Integer:
+                case JSONLeafKind::Integer64:
+                    return JSONScalar::of(leafValue<int64_t>(token, input));
+                case JSONLeafKind::Unsigned64:
+                    return JSONScalar::of(leafValue<uint64_t>(token, input));
+                case JSONLeafKind::Number:
+                    return JSONScalar::of(leafValue<double>(token, input));
+                case JSONLeafKind::Boolean:
+                    return JSONScalar::of(leafValue<bool>(token, input));
+                case JSONLeafKind::String:
+                    return JSONScalar::of(leafValue<StringView>(token, input));
+                default:
+                    return JSONScalar();
+                }
+            }
+        }
+
+        template <typename T>
+        constexpr bool isStdArray {false};
+
+        template <typename T, size_t N>
+        constexpr bool isStdArray<std::array<T, N>> {true};
+
+        template <typename T>
+        constexpr bool isJSONObject {false};
+
+        template <typename T>
+        constexpr bool isJSONObject<JSONObject<T>> {true};
+
+        template <typename T>
+        constexpr bool isJSONDict {false};
+
+        template <typename T, typename U>
+        constexpr bool isJSONDict<JSONDict<T, U>> {true};
+
+        template <typename T>
+        constexpr bool isJSONDictNode {false};
+
+        template <typename T, typename U>
+        constexpr bool isJSONDictNode<JSONDictNode<T, U>> {true};
+
+        /// fills a (nested) std::array from the array opened at index
+        /// @return index of the token after the array
+        template <typename T>
+        constexpr size_t fillArray(T &out, const JSONToken *tokens, size_t count, const char *input, size_t index) noexcept
+        {
+            ++index;
+            if (out.size() == 0) {
+                return index + 1;
+            }
+            for (size_t i = 0; i < out.size(); ++i) {
+                if constexpr (isStdArray<typename T::value_type>) {
+                    index = fillArray(out[i], tokens, count, input, index);
+                } else {
+                    out[i] = leafValue<typename T::value_type>(tokens[index], input);
+                    index = (tokens[index].type == TokenType::DictOpen) ? skipObject(tokens, count, index) : index + 1;
+                }
+                // comma or the closing bracket
+                ++index;
+            }
+            return index;
+        }
+
+        template <JSONLeafKind kind>
+        struct JSONLeafType
+        {
+            using type = JSONScalar;
+        };
+
+        template <>
+        struct JSONLeafType<JSONLeafKind::Integer>
+        {
+            using type = int32_t;
+        };
+
+        template <>
+        struct JSONLeafType<JSONLeafKind::Integer64>
+        {
+            using type = int64_t;
+        };
+
+        template <>
+        struct JSONLeafType<JSONLeafKind::Unsigned64>
+        {
+            using type = uint64_t;
+        };
+
+        template <>
+        struct JSONLeafType<JSONLeafKind::Number>
+        {
+            using type = double;
+        };
+
+        template <>
+        struct JSONLeafType<JSONLeafKind::Boolean>
+        {
+            using type = bool;
+        };
+
+        template <>
+        struct JSONLeafType<JSONLeafKind::String>
+        {
+            using type = StringView;
+        };
+
+        template <typename T, const JSONArrayShape &shape, size_t level = 0, bool leaf = (level == shape.depth)>
+        struct JSONNestedArray
+        {
+            using type = std::array<typename JSONNestedArray<T, shape, level + 1>::type, shape.dims[level]>;
+        };
+
+        template <typename T, const JSONArrayShape &shape, size_t level>
+        struct JSONNestedArray<T, shape, level, true>
+        {
+            using type = T;
+        };
+    } // namespace priv
+
+    template <TokenType Type, typename Value>
+    struct JSONBaseValue;
+
+    template <typename ParserResult>
+    class JSONDeclarator;
+
+    template <typename TokenList>
+    class JSONObjectParser;
+
+    ///
+    /// Array of the input, stored flat as a (nested) std::array of its element type:
+    /// int32_t, int64_t or uint64_t (the narrowest holding all integers), double (integers and fractions), bool, StringView
+    /// or JSONScalar for mixed values.
+    /// Nested arrays have to be rectangular, the shape is computed by constexpr functions
+    /// so the size of an array does not add template instantiations.
+    ///
+    template <typename InputString, size_t open>
+    class JSONArrayValue
+    {
+        using Tokens = JSONTokenArray<InputString>;
+        static constexpr StringView input{ InputString::asStringView() };
+
+        template <size_t idx, TokenType elementType = (idx < Tokens::count) ? Tokens::tokens[idx].type : TokenType::Invalid>
+        struct Element
+        {
+            using type = JSONBaseValue<elementType, typename JSONTokenizer<InputString, idx>::Token>;
+        };
+
+        template <size_t idx>
+        struct Element<idx, TokenType::Invalid>
+        {
+            using type = std::false_type;
+        };
+
+        template <size_t idx>
+        struct Element<idx, TokenType::ArrayOpen>
+        {
+            using type = JSONArrayValue<InputString, idx>;
+        };
+
+        template <size_t idx>
+        struct Element<idx, TokenType::DictOpen>
+        {
+            using type = typename JSONObjectParser<JSONTokenizer<InputString, idx>>::Result;
+        };
+
+    public:
+        static constexpr priv::JSONArrayShape shape{ priv::arrayShape(Tokens::tokens.data(), Tokens::count, input.data(), open) };
+        static constexpr bool success{ shape.valid };
+        static constexpr size_t length{ shape.dims[0] };
+        /// index of the token after the array
+        static constexpr size_t end{ shape.end };
+        static constexpr std::array<size_t, length> elements{ priv::arrayElements<length>(Tokens::tokens.data(), Tokens::count, input.data(), open) };
+
+        template <size_t idx>
+        using At = typename Element<(idx < length) ? elements[idx] : Tokens::count>::type;
+
+    private:
+        template <bool objects, typename = void>
+        struct Storage
+        {
+            using type = typename priv::JSONNestedArray<typename priv::JSONLeafType<shape.kind>::type, shape>::type;
+
+            static constexpr type create() noexcept
+            {
+                static_assert(shape.rectangular, "nested arrays need the same length on every nesting level");
+                static_assert(shape.kind != priv::JSONLeafKind::Overflow, "integer element does not fit int64_t or uint64_t");
+                static_assert(!shape.objects, "objects can not be mixed with other values or nested arrays in one array");
+                type result {};
+                priv::fillArray(result, Tokens::tokens.data(), Tokens::count, input.data(), open);
+                return result;
+            }
+        };
+
+        /// objects keep their own declarators, only a flat array of objects with the same members is supported
+        template <typename Unused>
+        struct Storage<true, Unused>
+        {
+            static_assert(shape.depth == 1, "arrays of objects can not be nested in other arrays");
+            using type = std::array<typename JSONDeclarator<At<0>>::ObjectType, length>;
+
+            template <size_t... I>
+            static constexpr type create(std::index_sequence<I...>) noexcept
+            {
+                constexpr bool sameMembers {(std::is_same_v<typename JSONDeclarator<At<I>>::ObjectType, typename JSONDeclarator<At<0>>::ObjectType> && ...)};
+                static_assert(sameMembers, "objects in one array need the same member names and types");
+                if constexpr (sameMembers) {
+                    return type{ JSONDeclarator<At<I>>::createObject()... };
+                } else {
+                    return type{ ((void)I, JSONDeclarator<At<0>>::createObject())... };
+                }
+            }
+            static constexpr type create() noexcept
+            {
+                return create(std::make_index_sequence<length>());
+            }
+        };
+
+        using Materialized = Storage<shape.kind == priv::JSONLeafKind::Object>;
+
+    public:
+        using ObjectType = typename Materialized::type;
+
+        static constexpr ObjectType createObject() noexcept
+        {
+            return Materialized::create();
+        }
+    };
+
     template <typename Name, TokenType type>
     class JSONObjectDeclarator;
 
@@ -309,14 +1093,26 @@ namespace ctjson
         }
     };
 
+    /// integers are int32_t, int64_t or uint64_t, whichever is the narrowest holding the value
     template <typename Token>
     class JSONObjectDeclarator<Token, TokenType::Number>
     {
+        static constexpr priv::JSONLeafKind kind {Token::isInteger() ? priv::integerLeafKind(Token::integerRange()) : priv::JSONLeafKind::Number};
+        static_assert(kind != priv::JSONLeafKind::Overflow, "integer does not fit int64_t or uint64_t");
+
     public:
-        using ObjectType = int32_t;
+        using ObjectType = typename priv::JSONLeafType<kind>::type;
         static constexpr ObjectType createObject() noexcept
         {
-            return Token::toInt();
+            if constexpr (kind == priv::JSONLeafKind::Number) {
+                return Token::toDouble();
+            } else if constexpr (kind == priv::JSONLeafKind::Unsigned64) {
+                return Token::toUInt64();
+            } else if constexpr (kind == priv::JSONLeafKind::Integer || kind == priv::JSONLeafKind::Integer64) {
+                return static_cast<ObjectType>(Token::toInt64());
+            } else {
+                return ObjectType();
+            }
         }
     };
 
@@ -342,31 +1138,33 @@ namespace ctjson
         }
     };
 
-    template <typename Name, typename First, typename ... Args>
-    class JSONNameValueObjectDeclarator<TokenType::ArrayOpen, Name, TypeList<First, Args...>>
+    template <typename ParserResult>
+    class JSONDeclarator
     {
     public:
-        using ArrayType = std::array<typename First::ObjectType, 1 + sizeof...(Args)>;
-        using ObjectType = JSONObject<ArrayType>;
+        using ObjectType = typename ParserResult::ObjectType;
         static constexpr ObjectType createObject() noexcept
         {
-            return ObjectType{ Name::asStringView(), ArrayType({First::createObject(), Args::createObject() ...}) };
+            return ParserResult::createObject();
         }
     };
 
-    template <typename ParserResult>
-    class JSONDeclarator
+    template <typename First>
+    class JSONDeclarator<TypeList<First>>
     {
     public:
-        using ObjectType = typename ParserResult::ObjectType;
+        using ObjectType = typename First::ObjectType;
         static constexpr ObjectType createObject() noexcept
         {
-            return ParserResult::createObject();
+            return First::createObject();
         }
     };
 
+    template <typename Entries>
+    class JSONDictNodeDeclarator;
+
     template <typename First>
-    class JSONDeclarator<TypeList<First>>
+    class JSONDictNodeDeclarator<TypeList<First>>
     {
     public:
         using ObjectType = typename First::ObjectType;
@@ -376,10 +1174,22 @@ namespace ctjson
         }
     };
 
+    template <typename First, typename ... Args>
+    class JSONDictNodeDeclarator<TypeList<First, Args...>>
+    {
+        using DeclRest = JSONDictNodeDeclarator<TypeList<Args...>>;
+    public:
+        using ObjectType = JSONDictNode<typename First::ObjectType, typename DeclRest::ObjectType>;
+        static constexpr ObjectType createObject() noexcept
+        {
+            return ObjectType{First::createObject(), DeclRest::createObject()};
+        }
+    };
+
     template <typename First, typename ... Args>
     class JSONDeclarator<TypeList<First, Args...>>
     {
-        using DeclRest = JSONDeclarator<TypeList<Args...>>;
+        using DeclRest = JSONDictNodeDeclarator<TypeList<Args...>>;
     public:
         using ObjectType = JSONDict<typename First::ObjectType, typename DeclRest::ObjectType>;
         static constexpr ObjectType createObject() noexcept
@@ -495,88 +1305,18 @@ namespace ctjson
         using NextTokens = std::conditional_t<success, typename TokenList::Next, TokenList>;
     };
 
-    template <typename ResultList, typename TokenList, TokenType token>
-    class ParseOneJSONArrayValue;
-
-    template <typename ResultList, typename TokenList>
-    class ParseOneJSONArrayValue<ResultList, TokenList, TokenType::ArrayOpen> {
-        using ParserImpl = ParseOneJSONArrayValue<ResultList, typename TokenList::Next, JSONTokenSpecs<typename TokenList::Next>::type>;
-
-    public:
-        using Result = typename ParserImpl::Result;
-
-        static constexpr bool success{
-            ParserImpl::success
-        };
-
-        using NextTokens = std::conditional_t<success, typename ParserImpl::NextTokens, TokenList>;
-    };
-
-    template <typename ResultList, typename TokenList>
-    class ParseOneJSONArrayValue<ResultList, TokenList, TokenType::ArrayClose> {
-    public:
-        using Result = ResultList;
-        using NextTokens = typename TokenList::Next;
-
-        static constexpr bool success{
-            true
-        };
-    };
-
-    template <typename ResultList, typename TokenList>
-    class ParseOneJSONArrayValue<ResultList, TokenList, TokenType::DictClose> {
-    public:
-        using Result = ResultList;
-        using NextTokens = TokenList;
-
-        static constexpr bool success{
-            false
-        };
-    };
-
-    template <typename ResultList, typename TokenList>
-    class ParseOneJSONArrayValue<ResultList, TokenList, TokenType::Comma> {
-        using ParserImpl = ParseOneJSONArrayValue<ResultList, typename TokenList::Next, JSONTokenSpecs<typename TokenList::Next>::type>;
-
-    public:
-        using Result = typename ParserImpl::Result;
-
-        static constexpr bool success{
-            ParserImpl::success
-        };
-
-        using NextTokens = std::conditional_t<success, typename ParserImpl::NextTokens, TokenList>;
-    };
-
-    template <typename ResultList, typename TokenList, TokenType token = JSONTokenSpecs<TokenList>::type>
-    class ParseOneJSONArrayValue {
-        using ParseValue = ParseJSONValueImpl<TokenList, token>;
-        using ThisResult = typename ResultList::template Append<typename ParseValue::Result>;
-
-        using ParserImpl = ParseOneJSONArrayValue<ThisResult, typename ParseValue::NextTokens>;
-
-    public:
-        using Result = typename ParserImpl::Result;
-
-        constexpr static bool success{
-            ParserImpl::success
-        };
-
-        using NextTokens = std::conditional_t<success, typename ParserImpl::NextTokens, TokenList>;
-    };
-
     template <typename TokenList>
     class ParseJSONArray {
-        using ParserImpl = ParseOneJSONArrayValue<EmptyTypeList, TokenList>;
+        using Array = JSONArrayValue<typename TokenList::Input, TokenList::position>;
 
     public:
-        using Result = typename ParserImpl::Result;
+        using Result = Array;
 
         constexpr static bool success{
-            ParserImpl::success
+            Array::success
         };
 
-        using NextTokens = std::conditional_t<success, typename ParserImpl::NextTokens, TokenList>;
+        using NextTokens = std::conditional_t<success, JSONTokenizer<typename TokenList::Input, Array::end>, TokenList>;
     };
 
     template <typename TokenList>
@@ -698,7 +1438,7 @@ namespace ctjson
     class JSONParser {
     private:
         using Tokens = JSONTokenizer<Input>;
-        using Parser = JSONObjectParser<Tokens>;
+        using Parser = std::conditional_t<Tokens::type == TokenType::ArrayOpen, ParseJSONArray<Tokens>, JSONObjectParser<Tokens>>;
 
     public:
         using Result = typename Parser::Result;
@@ -706,4 +1446,15 @@ namespace ctjson
             Parser::success
         };
     };
+
+    ///
+    /// Input of JSONParser spanning a whole constexpr char array, with or without a terminating '\0':
+    /// a header generated by embed_json.sh, or the contents of a file where the compiler supports #embed
+    ///     static constexpr const char config[] = {
+    ///     #embed "config.json"
+    ///     };
+    ///     using Parser = JSONParser<JSONText<config>>;
+    ///
+    template <const auto &text>
+    using JSONText = String<text, 0, sizeof(text) - (text[sizeof(text) - 1] == '\0' ? 1 : 0)>;
 } // namespace ctjson
@@ -0,0 +1,359 @@
+#pragma once
+
+#include "CTJson.h"
+#include "StructuralIndex.h"
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+///
+/// Binding of JSON objects to user defined structs
+///
+namespace ctjson
+{
+    ///
+    /// Entry of a field map, the name includes the quotes like all names in ctjson
+    ///
+    template <typename Class, typename T, size_t N>
+    struct JSONField
+    {
+        using Type = T;
+
+        const char (&name)[N];
+        T Class::*member;
+    };
+
+    template <typename Class, typename T, size_t N>
+    constexpr JSONField<Class, T, N> jsonField(const char (&name)[N], T Class::*member) noexcept
+    {
+        return { name, member };
+    }
+
+    ///
+    /// Field map of a struct, specializations provide
+    ///     static constexpr auto fields {std::make_tuple(jsonField("\"name\"", &T::name), ...)};
+    ///
+    template <typename T>
+    struct JSONBinding;
+
+    struct JSONBindResult
+    {
+        bool success {false};
+        /// offset of the token which could not be bound
+        size_t errorOffset {0};
+    };
+
+    namespace priv
+    {
+        template <typename T, typename = void>
+        constexpr bool hasJSONBinding {false};
+
+        template <typename T>
+        constexpr bool hasJSONBinding<T, std::void_t<decltype(JSONBinding<T>::fields)>> {true};
+
+        template <typename T>
+        constexpr size_t fieldCount {std::tuple_size_v<std::decay_t<decltype(JSONBinding<T>::fields)>>};
+
+        template <typename T, size_t I>
+        using FieldType = typename std::decay_t<decltype(std::get<I>(JSONBinding<T>::fields))>::Type;
+
+        /// Value of a direct entry of an object, nested objects are not searched
+        struct JSONDirectEntry
+        {
+            bool found {false};
+            JSONScalar value;
+        };
+
+        /// @return the first direct entry with this name in document order, like the runtime parser reads it
+        template <typename Object, size_t N>
+        constexpr JSONDirectEntry findEntry(const Object &object, const char (&name)[N]) noexcept
+        {
+            if constexpr (isJSONDict<Object>) {
+                return findEntry(object.entries(), name);
+            } else if constexpr (isJSONDictNode<Object>) {
+                const JSONDirectEntry entry {findEntry(object.node(), name)};
+                return entry.found ? entry : findEntry(object.next(), name);
+            } else if constexpr (isJSONObject<Object>) {
+                return object.name().equals(name) ? JSONDirectEntry {true, JSONScalar::of(object.value())} : JSONDirectEntry {};
+            } else {
+                return JSONDirectEntry {};
+            }
+        }
+
+        template <typename T, const auto &object, size_t I>
+        constexpr void bindField(T &result) noexcept
+        {
+            constexpr auto field {std::get<I>(JSONBinding<T>::fields)};
+            using Member = FieldType<T, I>;
+            static_assert(JSONScalar::holds<Member>, "only int32_t, int64_t, uint64_t, double, bool and StringView members can be bound at compile time");
+            constexpr JSONDirectEntry entry {findEntry(object, field.name)};
+            static_assert(entry.found, "field is missing from the JSON object");
+            static_assert(entry.value.template is<Member>(), "field has a different type in the JSON object");
+            result.*(field.member) = entry.value.template as<Member>();
+        }
+
+        template <typename T, const auto &object, size_t... I>
+        constexpr T bindFields(std::index_sequence<I...>) noexcept
+        {
+            T result {};
+            (bindField<T, object, I>(result), ...);
+            return result;
+        }
+
+        template <typename T, size_t... I>
+        constexpr std::array<StringView, sizeof...(I)> fieldNames(std::index_sequence<I...>) noexcept
+        {
+            return { StringView(std::get<I>(JSONBinding<T>::fields).name, sizeof(std::get<I>(JSONBinding<T>::fields).name) - 1) ... };
+        }
+
+        /// @return position of the first field with the same name, for every field
+        template <size_t count>
+        constexpr std::array<size_t, count> firstFields(const std::array<StringView, count> &names) noexcept
+        {
+            std::array<size_t, count> first {};
+            for (size_t i = 0; i < count; ++i) {
+                first[i] = i;
+                for (size_t j = 0; j < i; ++j) {
+                    if (names[j].equals(names[i])) {
+                        first[i] = j;
+                        break;
+                    }
+                }
+            }
+            return first;
+        }
+
+        /// @return true unless a field of bound struct type shares its name, the entry can only be parsed into one of them
+        template <typename T, size_t count, size_t... I>
+        constexpr bool structFieldsUnshared(const std::array<size_t, count> &first, std::index_sequence<I...>) noexcept
+        {
+            auto shared {[&first](size_t field) {
+                for (size_t i = 0; i < count; ++i) {
+                    if (i != field && first[i] == first[field]) {
+                        return true;
+                    }
+                }
+                return false;
+            }};
+            return ((!hasJSONBinding<FieldType<T, I>> || !shared(I)) && ...);
+        }
+
+        template <typename T>
+        struct JSONFieldIndex
+        {
+            static constexpr std::array<StringView, fieldCount<T>> names {fieldNames<T>(std::make_index_sequence<fieldCount<T>>())};
+            static constexpr JSONKeyIndex<fieldCount<T>> index {names};
+            /// fields sharing a name are all filled from the entry, find returns the first of them
+            static constexpr std::array<size_t, fieldCount<T>> first {firstFields(names)};
+            static_assert(structFieldsUnshared<T>(first, std::make_index_sequence<fieldCount<T>>()), "a field of bound struct type can not share its name with another field");
+
+            /// @return position of the field in the field map, npos if the struct has no such field
+            static size_t find(const StringView &name) noexcept
+            {
+                if (index.valid()) {
+                    return index.find(name);
+                }
+                for (size_t i = 0; i < names.size(); ++i) {
+                    if (names[i].equals(name)) {
+                        return i;
+                    }
+                }
+                return index.npos;
+            }
+        };
+
+        ///
+        /// Parses straight into the members of bound structs, entries without a field are skipped
+        ///
+        class JSONBindingParser
+        {
+        public:
+            JSONBindingParser(const char *str, size_t length)
+                : input_ {str}
+                , length_ {length}
+                , tokens_ {str, length}
+            {
+            }
+
+            template <typename T>
+            JSONBindResult parse(T &result)
+            {
+                JSONBindResult status;
+                status.success = parseObject(tokens_.next(), result);
+                if (status.success) {
+                    const JSONToken rest {tokens_.next()};
+                    if (rest.type != TokenType::Invalid || rest.offset != length_) {
+                        status.success = fail(rest);
+                    }
+                }
+                status.errorOffset = status.success ? 0 : errorOffset_;
+                return status;
+            }
+
+        private:
+            bool fail(const JSONToken &token) noexcept
+            {
+                errorOffset_ = token.offset;
+                return false;
+            }
+
+            template <typename T>
+            bool parseObject(const JSONToken &open, T &result)
+            {
+                using Fields = JSONFieldIndex<T>;
+                if (open.type != TokenType::DictOpen) {
+                    return fail(open);
+                }
+                std::array<bool, fieldCount<T>> seen {};
+                JSONToken token {tokens_.next()};
+                while (token.type != TokenType::DictClose) {
+                    if (token.type != TokenType::String) {
+                        return fail(token);
+                    }
+                    const size_t position {Fields::find(StringView(input_ + token.offset, token.length))};
+                    const JSONToken colon {tokens_.next()};
+                    if (colon.type != TokenType::Colon) {
+                        return fail(colon);
+                    }
+                    const JSONToken value {tokens_.next()};
+                    // like get(), the first of several entries with the same name wins
+                    if (position != Fields::index.npos && !seen[position]) {
+                        seen[position] = true;
+                        if (!parseFields(position, value, result, std::make_index_sequence<fieldCount<T>>())) {
+                            return false;
+                        }
+                    } else if (!skipValue(value)) {
+                        return false;
+                    }
+                    token = tokens_.next();
+                    if (token.type == TokenType::Comma) {
+                        token = tokens_.next();
+                        if (token.type == TokenType::DictClose) {
+                            return fail(token);
+                        }
+                    } else if (token.type != TokenType::DictClose) {
+                        return fail(token);
+                    }
+                }
+                for (size_t first : Fields::first) {
+                    if (!seen[first]) {
+                        return fail(token);
+                    }
+                }
+                return true;
+            }
+
+            /// parses the value into every field named like the one at position
+            template <typename T, size_t... I>
+            bool parseFields(size_t position, const JSONToken &value, T &result, std::index_sequence<I...>)
+            {
+                return ((JSONFieldIndex<T>::first[I] != position || parseValue(value, result.*(std::get<I>(JSONBinding<T>::fields).member))) && ...);
+            }
+
+            template <typename Member>
+            bool parseValue(const JSONToken &token, Member &member)
+            {
+                const char *str {input_ + token.offset};
+                if constexpr (std::is_same_v<Member, bool>) {
+                    if (token.type != TokenType::Boolean) {
+                        return fail(token);
+                    }
+                    member = (token.length == 4);
+                } else if constexpr (std::is_same_v<Member, int32_t> || std::is_same_v<Member, int64_t>) {
+                    if (token.type != TokenType::Number || !isIntegerNumber(str, token.length)) {
+                        return fail(token);
+                    }
+                    const IntegerRange range {integerRange(str, token.length)};
+                    if (range == IntegerRange::Overflow || range == IntegerRange::UInt64 || (std::is_same_v<Member, int32_t> && range != IntegerRange::Int32)) {
+                        return fail(token);
+                    }
+                    member = static_cast<Member>(parseInt64(str, token.length));
+                } else if constexpr (std::is_same_v<Member, uint64_t>) {
+                    if (token.type != TokenType::Number || !isIntegerNumber(str, token.length) || str[0] == '-'
+                        || integerRange(str, token.length) == IntegerRange::Overflow) {
+                        return fail(token);
+                    }
+                    member = parseUInt64(str, token.length);
+                } else if constexpr (std::is_same_v<Member, double>) {
+                    if (token.type != TokenType::Number) {
+                        return fail(token);
+                    }
+                    member = parseDouble(str, token.length);
+                } else if constexpr (std::is_same_v<Member, StringView>) {
+                    if (token.type != TokenType::String) {
+                        return fail(token);
+                    }
+                    member = StringView(str, token.length);
+                } else {
+                    static_assert(hasJSONBinding<Member>, "member type has no JSONBinding");
+                    return parseObject(token, member);
+                }
+                return true;
+            }
+
+            /// skips a value of an entry without a field, nested containers are only checked for balance
+            bool skipValue(const JSONToken &value)
+            {
+                size_t depth {0};
+                JSONToken token {value};
+                while (true) {
+                    switch (token.type) {
+                    case TokenType::DictOpen:
+                    case TokenType::ArrayOpen:
+                        ++depth;
+                        break;
+                    case TokenType::DictClose:
+                    case TokenType::ArrayClose:
+                        if (depth == 0) {
+                            return fail(token);
+                        }
+                        --depth;
+                        break;
+                    case TokenType::Invalid:
+                        return fail(token);
+                    case TokenType::Colon:
+                    case TokenType::Comma:
+                        if (depth == 0) {
+                            return fail(token);
+                        }
+                        break;
+                    default:
+                        break;
+                    }
+                    if (depth == 0) {
+                        return true;
+                    }
+                    token = tokens_.next();
+                }
+            }
+
+            const char *input_;
+            size_t length_;
+            JSONStructuralIndex tokens_;
+            size_t errorOffset_ {0};
+        };
+    } // namespace priv
+
+    ///
+    /// @return instance of T with every field of its JSONBinding taken from a constexpr object,
+    /// missing fields and fields of a different type are compile errors
+    ///
+    template <typename T, const auto &object>
+    constexpr T bindJSON() noexcept
+    {
+        return priv::bindFields<T, object>(std::make_index_sequence<priv::fieldCount<T>>());
+    }
+
+    ///
+    /// Parses a runtime JSON object straight into the members of result, without building a DOM.
+    /// Every field of the binding has to be present, members of bound struct types are parsed recursively.
+    /// StringView members point into the input.
+    ///
+    template <typename T>
+    JSONBindResult parseJSON(const char *str, size_t length, T &result)
+    {
+        return priv::JSONBindingParser(str, length).parse(result);
+    }
+} // namespace ctjson
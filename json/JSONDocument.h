@@ -0,0 +1,635 @@
+#pragma once
+
+#include "CTJson.h"
+#include "KeyIndex.h"
+#include "StructuralIndex.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+///
+/// Runtime counterpart of the ctjson parser, for input which is only known at runtime
+///
+namespace ctjson
+{
+    ///
+    /// Bump pointer allocator, memory is released only when the arena is destroyed
+    ///
+    class JSONArena
+    {
+    public:
+        explicit JSONArena(size_t blockSize = 64 * 1024)
+            : blockSize_ {blockSize}
+        {
+        }
+
+        /// @return uninitialized storage for count objects, T has to be trivially destructible
+        template <typename T>
+        T *allocate(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "arena never runs destructors");
+            const size_t bytes {count * sizeof(T)};
+            size_t padding {(alignof(T) - reinterpret_cast<uintptr_t>(cursor_) % alignof(T)) % alignof(T)};
+            if (cursor_ == nullptr || padding + bytes > left_) {
+                const size_t size {bytes + alignof(T) > blockSize_ ? bytes + alignof(T) : blockSize_};
+                blocks_.emplace_back(new unsigned char[size]);
+                firstBlockSize_ = (blocks_.size() == 1) ? size : firstBlockSize_;
+                cursor_ = blocks_.back().get();
+                left_ = size;
+                padding = (alignof(T) - reinterpret_cast<uintptr_t>(cursor_) % alignof(T)) % alignof(T);
+            }
+            T *result {reinterpret_cast<T *>(cursor_ + padding)};
+            cursor_ += padding + bytes;
+            left_ -= padding + bytes;
+            used_ += padding + bytes;
+            return result;
+        }
+
+        /// @return number of bytes handed out so far, including alignment
+        size_t used() const noexcept
+        {
+            return used_;
+        }
+
+        /// invalidates everything allocated so far, the first block is kept for reuse
+        void reset() noexcept
+        {
+            if (!blocks_.empty()) {
+                blocks_.erase(blocks_.begin() + 1, blocks_.end());
+                cursor_ = blocks_.front().get();
+                left_ = firstBlockSize_;
+            }
+            used_ = 0;
+        }
+
+    private:
+        std::vector<std::unique_ptr<unsigned char[]>> blocks_;
+        size_t blockSize_;
+        size_t firstBlockSize_ {0};
+        unsigned char *cursor_ {nullptr};
+        size_t left_ {0};
+        size_t used_ {0};
+    };
+
+    ///
+    /// Names of objects, every distinct name is stored once and referred to by a 32-bit id,
+    /// ids are handed out in order of first appearance. Names point into the parsed input and include their quotes.
+    ///
+    class JSONKeyPool
+    {
+    public:
+        static constexpr uint32_t npos {UINT32_MAX};
+
+        /// @return id of the name, added to the pool if it is new
+        uint32_t intern(const char *str, size_t length)
+        {
+            // records repeat their names in the order of first appearance, so the successor of the last id is tried first
+            const uint32_t expected {last_ + 1 < names_.size() ? last_ + 1 : 0};
+            if (expected < names_.size() && names_[expected].size() == length && std::memcmp(names_[expected].data(), str, length) == 0) {
+                return last_ = expected;
+            }
+            const uint64_t hashed {hash(str, length)};
+            size_t slot {probe(str, length, hashed)};
+            if (slots_.empty() || slots_[slot] == npos) {
+                // at most half of the slots are used
+                if (2 * (names_.size() + 1) > slots_.size()) {
+                    grow();
+                    slot = probe(str, length, hashed);
+                }
+                slots_[slot] = static_cast<uint32_t>(names_.size());
+                names_.emplace_back(str, length);
+                hashes_.push_back(hashed);
+            }
+            return last_ = slots_[slot];
+        }
+
+        /// @return id of the name, npos if it is not in the pool
+        uint32_t find(const char *str, size_t length) const noexcept
+        {
+            return slots_.empty() ? npos : slots_[probe(str, length, hash(str, length))];
+        }
+
+        template <size_t N>
+        uint32_t find(const char (&name)[N]) const noexcept
+        {
+            return find(name, N - 1);
+        }
+
+        StringView name(uint32_t id) const noexcept
+        {
+            return names_[id];
+        }
+
+        size_t size() const noexcept
+        {
+            return names_.size();
+        }
+
+        /// forgets all names, the memory is kept for reuse
+        void clear() noexcept
+        {
+            names_.clear();
+            hashes_.clear();
+            last_ = 0;
+            std::fill(slots_.begin(), slots_.end(), npos);
+        }
+
+    private:
+        /// names are short, they are hashed eight bytes at a time
+        static uint64_t hash(const char *str, size_t length) noexcept
+        {
+            uint64_t result {length * 0x9e3779b97f4a7c15ull};
+            uint64_t word {0};
+            for (; length >= 8; str += 8, length -= 8) {
+                std::memcpy(&word, str, 8);
+                result = (result ^ word) * 0xff51afd7ed558ccdull;
+                result ^= result >> 32;
+            }
+            word = 0;
+            for (size_t i = 0; i < length; ++i) {
+                word |= static_cast<uint64_t>(static_cast<uint8_t>(str[i])) << (8 * i);
+            }
+            result = (result ^ word) * 0xc4ceb9fe1a85ec53ull;
+            return result ^ (result >> 29);
+        }
+
+        /// @return slot of the name, or the free slot where it belongs
+        size_t probe(const char *str, size_t length, uint64_t hash) const noexcept
+        {
+            const size_t mask {slots_.size() - 1};
+            size_t slot {static_cast<size_t>(hash) & mask};
+            while (!slots_.empty() && slots_[slot] != npos) {
+                const uint32_t id {slots_[slot]};
+                if (hashes_[id] == hash && names_[id].size() == length && std::memcmp(names_[id].data(), str, length) == 0) {
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+            return slot;
+        }
+
+        void grow()
+        {
+            slots_.assign(slots_.empty() ? 64 : 2 * slots_.size(), npos);
+            const size_t mask {slots_.size() - 1};
+            for (uint32_t id = 0; id < names_.size(); ++id) {
+                size_t slot {static_cast<size_t>(hashes_[id]) & mask};
+                while (slots_[slot] != npos) {
+                    slot = (slot + 1) & mask;
+                }
+                slots_[slot] = id;
+            }
+        }
+
+        std::vector<StringView> names_;
+        std::vector<uint64_t> hashes_;
+        std::vector<uint32_t> slots_;
+        uint32_t last_ {0};
+    };
+
+    ///
+    /// Single value of a JSONDocument.
+    /// Strings point into the parsed input, arrays and objects point to their children in the arena.
+    /// Objects store their value nodes, followed by the key pool and the 32-bit ids of their names,
+    /// so lookups by id compare integers.
+    ///
+    class JSONNode
+    {
+    public:
+        enum class Type : uint8_t {
+            Null,
+            Boolean,
+            Integer,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        JSONNode() noexcept
+            : integer_ {0}
+        {
+        }
+
+        static JSONNode boolean(bool value) noexcept
+        {
+            JSONNode node;
+            node.type_ = Type::Boolean;
+            node.boolean_ = value;
+            return node;
+        }
+        static JSONNode integer(int64_t value) noexcept
+        {
+            JSONNode node;
+            node.type_ = Type::Integer;
+            node.integer_ = value;
+            return node;
+        }
+        /// integers above the int64_t range
+        static JSONNode unsignedInteger(uint64_t value) noexcept
+        {
+            JSONNode node;
+            node.type_ = Type::Integer;
+            node.unsigned_ = value;
+            node.isUnsigned_ = true;
+            return node;
+        }
+        static JSONNode number(double value) noexcept
+        {
+            JSONNode node;
+            node.type_ = Type::Number;
+            node.number_ = value;
+            return node;
+        }
+        static JSONNode string(const char *str, uint32_t length) noexcept
+        {
+            JSONNode node;
+            node.type_ = Type::String;
+            node.string_ = str;
+            node.size_ = length;
+            return node;
+        }
+        static JSONNode container(Type type, const JSONNode *children, uint32_t size) noexcept
+        {
+            JSONNode node;
+            node.type_ = type;
+            node.children_ = children;
+            node.size_ = size;
+            return node;
+        }
+
+        Type type() const noexcept
+        {
+            return type_;
+        }
+
+        /// @return number of elements of an array, entries of an object or characters of a string
+        size_t size() const noexcept
+        {
+            return (type_ == Type::Array || type_ == Type::Object || type_ == Type::String) ? size_ : 0;
+        }
+
+        /// @return element of an array or value of an object entry
+        const JSONNode &operator[](size_t idx) const noexcept
+        {
+            return children_[idx];
+        }
+
+        /// @return name of an object entry
+        StringView name(size_t idx) const noexcept
+        {
+            return keys()->name(keyIds()[idx]);
+        }
+
+        /// @return id of the name of an object entry in the key pool of the document
+        uint32_t keyId(size_t idx) const noexcept
+        {
+            return keyIds()[idx];
+        }
+
+        /// @return number of nodes to allocate for an object with this number of entries
+        static constexpr size_t objectStorage(size_t count) noexcept
+        {
+            return count + (sizeof(const JSONKeyPool *) + count * sizeof(uint32_t) + sizeof(JSONNode) - 1) / sizeof(JSONNode);
+        }
+
+        /// object over storage from objectStorage, the values have to be in place already
+        static JSONNode object(JSONNode *storage, uint32_t count, const JSONKeyPool *keys, const uint32_t *ids) noexcept
+        {
+            unsigned char *tail {reinterpret_cast<unsigned char *>(storage + count)};
+            std::memcpy(tail, &keys, sizeof(keys));
+            if (count != 0) {
+                std::memcpy(tail + sizeof(keys), ids, count * sizeof(uint32_t));
+            }
+            return container(Type::Object, storage, count);
+        }
+
+        /// @return the value if it has type T or converts to it without loss (as JSONScalar::as), default value otherwise
+        template <typename T>
+        JSONValueWrapper<T> as() const noexcept
+        {
+            if constexpr (std::is_same_v<T, bool>) {
+                return (type_ == Type::Boolean) ? JSONValueWrapper<T>(boolean_) : JSONValueWrapper<T>();
+            } else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> || std::is_same_v<T, double>) {
+                if (type_ == Type::Integer) {
+                    return isUnsigned_ ? JSONScalar::of(unsigned_).as<T>() : JSONScalar::of(integer_).as<T>();
+                }
+                return (type_ == Type::Number) ? JSONScalar::of(number_).as<T>() : JSONValueWrapper<T>();
+            } else if constexpr (std::is_same_v<T, StringView>) {
+                return (type_ == Type::String) ? JSONValueWrapper<T>(StringView(string_, size_)) : JSONValueWrapper<T>();
+            } else {
+                return JSONValueWrapper<T>();
+            }
+        }
+
+        /// @return value of the first entry with this name, depth first as in JSONDict, nullptr if not found
+        template <size_t N>
+        const JSONNode *find(const char (&name)[N]) const noexcept
+        {
+            // every object of a document shares its key pool, a name missing there is nowhere in the tree
+            return (type_ == Type::Object) ? find(keys()->find(name)) : nullptr;
+        }
+
+        /// @return value of the first entry with this key id, depth first, nullptr if not found
+        const JSONNode *find(uint32_t key) const noexcept
+        {
+            if (type_ != Type::Object || key == JSONKeyPool::npos) {
+                return nullptr;
+            }
+            const uint32_t *ids {keyIds()};
+            for (size_t i = 0; i < size_; ++i) {
+                if (ids[i] == key) {
+                    return &children_[i];
+                }
+                if (const JSONNode *nested {children_[i].find(key)}) {
+                    return nested;
+                }
+            }
+            return nullptr;
+        }
+
+        template <size_t N>
+        bool contains(const char (&name)[N]) const noexcept
+        {
+            return find(name) != nullptr;
+        }
+
+        template <typename T, size_t N>
+        JSONValueWrapper<T> get(const char (&name)[N]) const noexcept
+        {
+            const JSONNode *node {find(name)};
+            return node ? node->as<T>() : JSONValueWrapper<T>();
+        }
+
+        template <typename T>
+        JSONValueWrapper<T> get(uint32_t key) const noexcept
+        {
+            const JSONNode *node {find(key)};
+            return node ? node->as<T>() : JSONValueWrapper<T>();
+        }
+
+    private:
+        const JSONKeyPool *keys() const noexcept
+        {
+            const JSONKeyPool *keys {nullptr};
+            std::memcpy(&keys, children_ + size_, sizeof(keys));
+            return keys;
+        }
+
+        const uint32_t *keyIds() const noexcept
+        {
+            return reinterpret_cast<const uint32_t *>(reinterpret_cast<const unsigned char *>(children_ + size_) + sizeof(const JSONKeyPool *));
+        }
+
+        union {
+            int64_t integer_;
+            uint64_t unsigned_;
+            double number_;
+            bool boolean_;
+            const char *string_;
+            const JSONNode *children_;
+        };
+        uint32_t size_ {0};
+        Type type_ {Type::Null};
+        bool isUnsigned_ {false};
+    };
+
+    static_assert(sizeof(JSONNode) == 16, "JSONNode has to stay compact");
+    static_assert(std::is_trivially_copyable_v<JSONNode> && std::is_trivially_destructible_v<JSONNode>, "JSONNode lives in the arena");
+
+    ///
+    /// DOM of a JSON text parsed at runtime with the ctjson tokenizer, driven by a JSONStructuralIndex.
+    /// The input buffer has to outlive the document.
+    ///
+    class JSONDocument
+    {
+    public:
+        /// nesting limit, deeper input is rejected instead of exhausting the stack
+        static constexpr size_t maxDepth {512};
+
+        JSONDocument(const char *str, size_t length)
+            : JSONDocument(str, length, nullptr, nullptr)
+        {
+        }
+
+        /// nodes are allocated in the given arena, which has to outlive the document
+        JSONDocument(const char *str, size_t length, JSONArena &arena)
+            : JSONDocument(str, length, &arena, nullptr)
+        {
+        }
+
+        /// names are added to the given key pool, which has to outlive the document; its names refer to every input parsed with it
+        JSONDocument(const char *str, size_t length, JSONArena &arena, JSONKeyPool &keys)
+            : JSONDocument(str, length, &arena, &keys)
+        {
+        }
+
+        /// the input is indexed with the given index, which keeps its buffers for the next document parsed with it
+        JSONDocument(const char *str, size_t length, JSONArena &arena, JSONKeyPool &keys, JSONStructuralIndex &tokens)
+            : JSONDocument(str, length, &arena, &keys, &tokens)
+        {
+        }
+
+        explicit JSONDocument(const std::string &str)
+            : JSONDocument(str.data(), str.size())
+        {
+        }
+
+        JSONDocument(const JSONDocument &) = delete;
+        JSONDocument &operator=(const JSONDocument &) = delete;
+
+        bool success() const noexcept
+        {
+            return success_;
+        }
+
+        /// @return offset of the token which could not be parsed
+        size_t errorOffset() const noexcept
+        {
+            return errorOffset_;
+        }
+
+        const JSONNode &root() const noexcept
+        {
+            return root_;
+        }
+
+        /// @return number of arena bytes used so far, a shared arena includes the other documents
+        size_t memoryUsage() const noexcept
+        {
+            return arena_->used();
+        }
+
+        /// names of all objects, ids from it make lookups integer compares
+        const JSONKeyPool &keys() const noexcept
+        {
+            return *keys_;
+        }
+
+        template <size_t N>
+        bool contains(const char (&name)[N]) const noexcept
+        {
+            return root_.contains(name);
+        }
+
+        template <typename T, size_t N>
+        JSONValueWrapper<T> get(const char (&name)[N]) const noexcept
+        {
+            return root_.get<T>(name);
+        }
+
+    private:
+        JSONDocument(const char *str, size_t length, JSONArena *arena, JSONKeyPool *keys, JSONStructuralIndex *tokens = nullptr)
+            : input_ {str}
+            , length_ {length}
+            , tokens_ {tokens ? tokens : &ownTokens_}
+            , arena_ {arena ? arena : &ownArena_}
+            , keys_ {keys ? keys : &ownKeys_}
+        {
+            tokens_->reset(str, length);
+            // room for a typical record, larger documents grow the stack as needed
+            stack_.reserve(64);
+            keyStack_.reserve(32);
+            JSONNode root;
+            success_ = parseValue(root, 0);
+            if (success_) {
+                const JSONToken rest {tokens_->next()};
+                if (rest.type != TokenType::Invalid || rest.offset != length_) {
+                    success_ = false;
+                    errorOffset_ = rest.offset;
+                }
+            }
+            if (success_) {
+                root_ = root;
+            }
+            stack_ = std::vector<JSONNode>();
+            keyStack_ = std::vector<uint32_t>();
+        }
+
+        JSONToken nextToken() noexcept
+        {
+            return tokens_->next();
+        }
+
+        bool fail(const JSONToken &token) noexcept
+        {
+            errorOffset_ = token.offset;
+            return false;
+        }
+
+        bool parseValue(JSONNode &result, size_t depth)
+        {
+            const JSONToken token {nextToken()};
+            return parseValue(token, result, depth);
+        }
+
+        bool parseValue(const JSONToken &token, JSONNode &result, size_t depth)
+        {
+            const char *str {input_ + token.offset};
+            switch (token.type) {
+            case TokenType::String:
+                if (token.length > UINT32_MAX) {
+                    return fail(token);
+                }
+                result = JSONNode::string(str, static_cast<uint32_t>(token.length));
+                return true;
+            case TokenType::Number: {
+                // integers beyond the uint64_t range are kept as their nearest double
+                const IntegerRange range {isIntegerNumber(str, token.length) ? integerRange(str, token.length) : IntegerRange::Overflow};
+                if (range == IntegerRange::Int32 || range == IntegerRange::Int64) {
+                    result = JSONNode::integer(parseInt64(str, token.length));
+                } else if (range == IntegerRange::UInt64) {
+                    result = JSONNode::unsignedInteger(parseUInt64(str, token.length));
+                } else {
+                    result = JSONNode::number(parseDouble(str, token.length));
+                }
+                return true;
+            }
+            case TokenType::Boolean:
+                result = JSONNode::boolean(token.length == 4);
+                return true;
+            case TokenType::Null:
+                result = JSONNode();
+                return true;
+            case TokenType::DictOpen:
+            case TokenType::ArrayOpen:
+                return (depth < maxDepth) ? parseContainer(token, result, depth + 1) : fail(token);
+            default:
+                return fail(token);
+            }
+        }
+
+        /// children (and the ids of the names) are collected on the stacks and moved to the arena in one block once the container is closed
+        bool parseContainer(const JSONToken &open, JSONNode &result, size_t depth)
+        {
+            const bool isObject {open.type == TokenType::DictOpen};
+            const TokenType close {isObject ? TokenType::DictClose : TokenType::ArrayClose};
+            const size_t base {stack_.size()};
+            const size_t keyBase {keyStack_.size()};
+            JSONToken token {nextToken()};
+            if (token.type != close) {
+                while (true) {
+                    JSONNode node;
+                    if (isObject) {
+                        if (token.type != TokenType::String) {
+                            return fail(token);
+                        }
+                        keyStack_.push_back(keys_->intern(input_ + token.offset, token.length));
+                        token = nextToken();
+                        if (token.type != TokenType::Colon) {
+                            return fail(token);
+                        }
+                        token = nextToken();
+                    }
+                    if (!parseValue(token, node, depth)) {
+                        return false;
+                    }
+                    stack_.push_back(node);
+                    token = nextToken();
+                    if (token.type == close) {
+                        break;
+                    }
+                    if (token.type != TokenType::Comma) {
+                        return fail(token);
+                    }
+                    token = nextToken();
+                }
+            }
+            const size_t count {stack_.size() - base};
+            if (count > UINT32_MAX) {
+                return fail(open);
+            }
+            JSONNode *children {arena_->allocate<JSONNode>(isObject ? JSONNode::objectStorage(count) : count)};
+            if (count != 0) {
+                std::memcpy(children, stack_.data() + base, count * sizeof(JSONNode));
+            }
+            stack_.resize(base);
+            if (isObject) {
+                result = JSONNode::object(children, static_cast<uint32_t>(count), keys_, keyStack_.data() + keyBase);
+                keyStack_.resize(keyBase);
+            } else {
+                result = JSONNode::container(JSONNode::Type::Array, children, static_cast<uint32_t>(count));
+            }
+            return true;
+        }
+
+        const char *input_;
+        size_t length_;
+        JSONStructuralIndex ownTokens_;
+        JSONStructuralIndex *tokens_;
+        bool success_ {false};
+        size_t errorOffset_ {0};
+        JSONNode root_;
+        JSONArena ownArena_;
+        JSONArena *arena_;
+        JSONKeyPool ownKeys_;
+        JSONKeyPool *keys_;
+        std::vector<JSONNode> stack_;
+        std::vector<uint32_t> keyStack_;
+    };
+} // namespace ctjson
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "CTJson.h"
+#include "KeyIndex.h"
+#include "NumberUtils.h"
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+///
+/// Flattening of constexpr object trees into sorted tables of dotted paths, for lookups without walking JSONDict chains
+///
+namespace ctjson
+{
+    /// Scalar of a flattened tree and its path: names without their quotes and array indices, joined by '.'
+    struct JSONFlatEntry
+    {
+        StringView path;
+        JSONScalar value;
+    };
+
+    namespace priv
+    {
+        /// sizes of a flattened tree, taken by a first pass over it
+        struct JSONFlatSize
+        {
+            size_t count {0};
+            size_t textLength {0};
+            size_t maxPathLength {0};
+        };
+
+        /// @return true if a orders before b, byte by byte and shorter first
+        constexpr bool pathLess(const StringView &a, const StringView &b) noexcept
+        {
+            for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+                if (a.data()[i] != b.data()[i]) {
+                    return static_cast<unsigned char>(a.data()[i]) < static_cast<unsigned char>(b.data()[i]);
+                }
+            }
+            return a.size() < b.size();
+        }
+
+        /// appends a path segment, path is nullptr while only lengths are counted
+        /// @return new length of the path
+        constexpr size_t appendSegment(char *path, size_t length, const char *str, size_t size) noexcept
+        {
+            const size_t begin {length != 0 ? length + 1 : 0};
+            if (path != nullptr) {
+                if (length != 0) {
+                    path[length] = '.';
+                }
+                for (size_t i = 0; i < size; ++i) {
+                    path[begin + i] = str[i];
+                }
+            }
+            return begin + size;
+        }
+
+        template <typename T, typename Visit>
+        constexpr void visitLeaves(const T &value, char *path, size_t length, Visit &visit) noexcept;
+
+        template <typename T, typename Visit>
+        constexpr void visitEntries(const T &entries, char *path, size_t length, Visit &visit) noexcept
+        {
+            if constexpr (isJSONDictNode<T>) {
+                visitEntries(entries.node(), path, length, visit);
+                visitEntries(entries.next(), path, length, visit);
+            } else {
+                const StringView &name {entries.name()};
+                visitLeaves(entries.value(), path, appendSegment(path, length, name.data() + 1, name.size() - 2), visit);
+            }
+        }
+
+        /// calls visit with the path and value of every scalar of the tree, depth first in document order
+        template <typename T, typename Visit>
+        constexpr void visitLeaves(const T &value, char *path, size_t length, Visit &visit) noexcept
+        {
+            if constexpr (isStdArray<T>) {
+                for (size_t i = 0; i < value.size(); ++i) {
+                    char digits[maxNumberLength] {};
+                    const size_t size {formatUnsigned(i, digits)};
+                    visitLeaves(value[i], path, appendSegment(path, length, digits, size), visit);
+                }
+            } else if constexpr (isJSONDict<T>) {
+                visitEntries(value.entries(), path, length, visit);
+            } else if constexpr (isJSONObject<T>) {
+                visitEntries(value, path, length, visit);
+            } else if constexpr (std::is_same_v<T, JSONScalar>) {
+                visit(path, length, value);
+            } else {
+                visit(path, length, JSONScalar::of(value));
+            }
+        }
+
+        template <typename T>
+        constexpr JSONFlatSize flatSize(const T &object) noexcept
+        {
+            JSONFlatSize size;
+            auto count {[&size](const char *, size_t length, const JSONScalar &) {
+                ++size.count;
+                size.textLength += length;
+                size.maxPathLength = (length > size.maxPathLength) ? length : size.maxPathLength;
+            }};
+            visitLeaves(object, nullptr, 0, count);
+            return size;
+        }
+
+        /// @return paths of all scalars, concatenated in document order
+        template <size_t textLength, size_t maxPathLength, typename T>
+        constexpr std::array<char, textLength + 1> flatText(const T &object) noexcept
+        {
+            std::array<char, textLength + 1> text {};
+            char path[maxPathLength + 1] {};
+            size_t offset {0};
+            auto copy {[&text, &path, &offset](const char *, size_t length, const JSONScalar &) {
+                for (size_t i = 0; i < length; ++i) {
+                    text[offset + i] = path[i];
+                }
+                offset += length;
+            }};
+            visitLeaves(object, path, 0, copy);
+            return text;
+        }
+
+        template <size_t count>
+        constexpr void siftDown(const std::array<JSONFlatEntry, count> &entries, std::array<size_t, count> &order, size_t root, size_t size) noexcept
+        {
+            // equal paths keep document order, so duplicate names resolve to the first one as in JSONDict
+            auto less {[&entries](size_t a, size_t b) {
+                return pathLess(entries[a].path, entries[b].path) || (!pathLess(entries[b].path, entries[a].path) && a < b);
+            }};
+            while (2 * root + 1 < size) {
+                size_t child {2 * root + 1};
+                if (child + 1 < size && less(order[child], order[child + 1])) {
+                    ++child;
+                }
+                if (!less(order[root], order[child])) {
+                    return;
+                }
+                const size_t swapped {order[root]};
+                order[root] = order[child];
+                order[child] = swapped;
+                root = child;
+            }
+        }
+
+        /// @return entries of all scalars sorted by path (heap sort), paths point into text
+        template <size_t count, typename T>
+        constexpr std::array<JSONFlatEntry, count> flatEntries(const T &object, const char *text) noexcept
+        {
+            std::array<JSONFlatEntry, count> entries {};
+            size_t index {0};
+            size_t offset {0};
+            auto collect {[&entries, &index, &offset, text](const char *, size_t length, const JSONScalar &value) {
+                entries[index++] = JSONFlatEntry {StringView(text + offset, length), value};
+                offset += length;
+            }};
+            visitLeaves(object, nullptr, 0, collect);
+
+            std::array<size_t, count> order {};
+            for (size_t i = 0; i < count; ++i) {
+                order[i] = i;
+            }
+            for (size_t i = count / 2; i > 0; --i) {
+                siftDown(entries, order, i - 1, count);
+            }
+            for (size_t size = count; size > 1; --size) {
+                const size_t largest {order[0]};
+                order[0] = order[size - 1];
+                order[size - 1] = largest;
+                siftDown(entries, order, 0, size - 1);
+            }
+            std::array<JSONFlatEntry, count> sorted {};
+            for (size_t i = 0; i < count; ++i) {
+                sorted[i] = entries[order[i]];
+            }
+            return sorted;
+        }
+
+        template <size_t count>
+        constexpr std::array<StringView, count> flatPaths(const std::array<JSONFlatEntry, count> &entries) noexcept
+        {
+            std::array<StringView, count> paths {};
+            for (size_t i = 0; i < count; ++i) {
+                paths[i] = entries[i].path;
+            }
+            return paths;
+        }
+    } // namespace priv
+
+    ///
+    /// Every scalar of a constexpr object tree (JSONObject, JSONDict or array) as a table sorted by dotted path,
+    /// e.g. "server.ports.0" for {"server": {"ports": [80]}}. Names are taken verbatim from the input, escapes included,
+    /// so a name holding a '.' can not be told apart from nesting. Empty objects and arrays have no entries.
+    /// find hashes the path once (JSONKeyIndex) and compares it with a single entry, lowerBound is a binary search
+    /// for iterating over all paths with a common prefix.
+    ///
+    template <const auto &object>
+    class JSONFlatTable
+    {
+        static constexpr priv::JSONFlatSize size {priv::flatSize(object)};
+
+    public:
+        static constexpr size_t count {size.count};
+
+        /// paths of all entries, in document order
+        static constexpr std::array<char, size.textLength + 1> text {priv::flatText<size.textLength, size.maxPathLength>(object)};
+        static constexpr std::array<JSONFlatEntry, count> entries {priv::flatEntries<count>(object, text.data())};
+        static constexpr JSONKeyIndex<count> index {priv::flatPaths(entries)};
+
+        /// @return entry with this path, nullptr if there is none
+        static constexpr const JSONFlatEntry *find(const StringView &path) noexcept
+        {
+            if (index.valid()) {
+                const size_t position {index.find(path)};
+                return (position != JSONKeyIndex<count>::npos) ? &entries[position] : nullptr;
+            }
+            const size_t position {lowerBound(path)};
+            return (position < count && entries[position].path.equals(path)) ? &entries[position] : nullptr;
+        }
+
+        template <size_t N>
+        static constexpr const JSONFlatEntry *find(const char (&path)[N]) noexcept
+        {
+            return find(StringView(path, N - 1));
+        }
+
+        /// @return the value at this path if it has type T or converts to it without loss, default value otherwise
+        template <typename T, size_t N>
+        static constexpr JSONValueWrapper<T> get(const char (&path)[N]) noexcept
+        {
+            const JSONFlatEntry *entry {find(path)};
+            return (entry != nullptr) ? entry->value.template as<T>() : JSONValueWrapper<T>();
+        }
+
+        /// @return position of the first entry whose path does not order before this one
+        static constexpr size_t lowerBound(const StringView &path) noexcept
+        {
+            size_t first {0};
+            size_t last {count};
+            while (first < last) {
+                const size_t middle {first + (last - first) / 2};
+                if (priv::pathLess(entries[middle].path, path)) {
+                    first = middle + 1;
+                } else {
+                    last = middle;
+                }
+            }
+            return first;
+        }
+    };
+} // namespace ctjson
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "JSONDocument.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+///
+/// Parallel parsing of line delimited JSON (NDJSON), one document per line
+///
+namespace ctjson
+{
+#if defined(__unix__) || defined(__APPLE__)
+    ///
+    /// Read only memory mapping of a whole file
+    ///
+    class JSONMappedFile
+    {
+    public:
+        explicit JSONMappedFile(const char *path) noexcept
+        {
+            const int fd {::open(path, O_RDONLY)};
+            if (fd < 0) {
+                return;
+            }
+            struct stat info;
+            if (::fstat(fd, &info) != 0) {
+                ::close(fd);
+                return;
+            }
+            if (info.st_size > 0) {
+                void *data {::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0)};
+                if (data != MAP_FAILED) {
+                    ::madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                    data_ = static_cast<const char *>(data);
+                    size_ = static_cast<size_t>(info.st_size);
+                }
+            }
+            valid_ = (data_ != nullptr) || (info.st_size == 0);
+            ::close(fd);
+        }
+
+        ~JSONMappedFile()
+        {
+            if (data_) {
+                ::munmap(const_cast<char *>(data_), size_);
+            }
+        }
+
+        JSONMappedFile(const JSONMappedFile &) = delete;
+        JSONMappedFile &operator=(const JSONMappedFile &) = delete;
+
+        bool valid() const noexcept
+        {
+            return valid_;
+        }
+        const char *data() const noexcept
+        {
+            return data_;
+        }
+        size_t size() const noexcept
+        {
+            return size_;
+        }
+
+    private:
+        const char *data_ {nullptr};
+        size_t size_ {0};
+        bool valid_ {false};
+    };
+#endif
+
+    struct JSONLinesResult
+    {
+        size_t records {0};
+        size_t errors {0};
+        /// input offset of the first malformed token, only meaningful if errors is not zero
+        size_t firstErrorOffset {0};
+    };
+
+    namespace priv
+    {
+        /// @return position after the first newline at or after pos
+        inline size_t nextLine(const char *str, size_t length, size_t pos) noexcept
+        {
+            const void *newline {pos < length ? std::memchr(str + pos, '\n', length - pos) : nullptr};
+            return newline ? static_cast<size_t>(static_cast<const char *>(newline) - str) + 1 : length;
+        }
+
+        template <typename Callback>
+        JSONLinesResult parseLines(const char *str, size_t begin, size_t end, size_t thread, Callback &callback)
+        {
+            JSONLinesResult result;
+            JSONArena arena;
+            // the names of all lines stay valid with the input, so one pool serves every record of the thread
+            JSONKeyPool keys;
+            // reindexed per line, its buffers grow to the longest line of the thread
+            JSONStructuralIndex tokens;
+            for (size_t line = begin; line < end;) {
+                const size_t next {nextLine(str, end, line)};
+                // blank lines separate nothing and are skipped
+                if (skipWhitespace(str, next, line) != next) {
+                    const JSONDocument document {str + line, next - line, arena, keys, tokens};
+                    if (document.success()) {
+                        ++result.records;
+                        callback(document.root(), thread);
+                    } else if (result.errors++ == 0) {
+                        result.firstErrorOffset = line + document.errorOffset();
+                    }
+                    arena.reset();
+                }
+                line = next;
+            }
+            return result;
+        }
+    } // namespace priv
+
+    ///
+    /// Splits the input at line boundaries into one chunk per thread and parses every line into its own document.
+    /// callback(const JSONNode &record, size_t thread) is called concurrently from the worker threads,
+    /// records of one thread arrive in input order and stay valid only until the callback returns.
+    ///
+    template <typename Callback>
+    JSONLinesResult parseJSONLines(const char *str, size_t length, size_t threads, Callback &&callback)
+    {
+        threads = std::max<size_t>(1, std::min(threads, length / 4096 + 1));
+        std::vector<size_t> bounds {0};
+        for (size_t i = 1; i < threads; ++i) {
+            bounds.push_back(std::max(bounds.back(), priv::nextLine(str, length, length / threads * i)));
+        }
+        bounds.push_back(length);
+
+        std::vector<JSONLinesResult> results(threads);
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < threads; ++i) {
+            workers.emplace_back([&, i]() { results[i] = priv::parseLines(str, bounds[i], bounds[i + 1], i, callback); });
+        }
+        results[0] = priv::parseLines(str, bounds[0], bounds[1], 0, callback);
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+
+        JSONLinesResult total;
+        for (const JSONLinesResult &result : results) {
+            if (result.errors != 0 && total.errors == 0) {
+                total.firstErrorOffset = result.firstErrorOffset;
+            }
+            total.records += result.records;
+            total.errors += result.errors;
+        }
+        return total;
+    }
+} // namespace ctjson
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "JSONWriter.h"
+#include "StringUtils.h"
+#include "Tokenizer.h"
+#include <array>
+#include <cstddef>
+#include <utility>
+
+///
+/// JSON Merge Patch (RFC 7386) of documents, at compile time to layer configurations into a single constexpr document
+///
+namespace ctjson
+{
+    namespace priv
+    {
+        constexpr size_t noTarget {static_cast<size_t>(-1)};
+
+        /// @return position of the value of the first entry with this name in the object at pos, 0 if there is none
+        constexpr size_t findEntry(const char *str, size_t length, size_t pos, const StringView &name) noexcept
+        {
+            bool done {false};
+            for (pos = firstItem(str, length, pos, '}', done); !done;) {
+                JSONToken key {};
+                const size_t value {objectEntry(str, length, pos, key)};
+                const size_t end {value != 0 ? skipValue(str, length, value) : 0};
+                if (end == 0) {
+                    return 0;
+                }
+                if (name.equals(StringView(str + key.offset, key.length))) {
+                    return value;
+                }
+                pos = nextItem(str, length, end, '}', done);
+                if (pos == 0) {
+                    return 0;
+                }
+            }
+            return 0;
+        }
+
+        constexpr void writeEntryName(JSONOutput &out, const char *str, const JSONToken &key, bool &first) noexcept
+        {
+            if (!first) {
+                out.put(',');
+            }
+            first = false;
+            out.write(str + key.offset, key.length);
+            out.put(':');
+        }
+
+        /// writes the patch applied to the target value at targetPos (noTarget if there is none)
+        /// @return false if a walked part of either document is malformed
+        constexpr bool mergeValue(JSONOutput &out, const char *target, size_t targetLength, size_t targetPos, const char *patch, size_t patchLength,
+            size_t patchPos) noexcept
+        {
+            const size_t patchEnd {skipValue(patch, patchLength, patchPos)};
+            if (patchEnd == 0) {
+                return false;
+            }
+            if (patch[patchPos] != '{') {
+                out.write(patch + patchPos, patchEnd - patchPos);
+                return true;
+            }
+            const bool targetObject {targetPos != noTarget && target[targetPos] == '{'};
+            bool first {true};
+            out.put('{');
+            // entries of the target keep their order, the patch replaces or removes them
+            bool done {!targetObject};
+            for (size_t pos = targetObject ? firstItem(target, targetLength, targetPos, '}', done) : 0; !done;) {
+                JSONToken key {};
+                const size_t value {objectEntry(target, targetLength, pos, key)};
+                const size_t end {value != 0 ? skipValue(target, targetLength, value) : 0};
+                if (end == 0) {
+                    return false;
+                }
+                const StringView name {target + key.offset, key.length};
+                // of duplicate names only the first entry counts
+                if (findEntry(target, targetLength, targetPos, name) == value) {
+                    const size_t replacement {findEntry(patch, patchLength, patchPos, name)};
+                    if (replacement == 0) {
+                        writeEntryName(out, target, key, first);
+                        out.write(target + value, end - value);
+                    } else if (patch[replacement] != 'n') {
+                        writeEntryName(out, target, key, first);
+                        if (!mergeValue(out, target, targetLength, value, patch, patchLength, replacement)) {
+                            return false;
+                        }
+                    }
+                }
+                pos = nextItem(target, targetLength, end, '}', done);
+                if (pos == 0) {
+                    return false;
+                }
+            }
+            // entries new in the patch follow, null only removes
+            done = false;
+            for (size_t pos = firstItem(patch, patchLength, patchPos, '}', done); !done;) {
+                JSONToken key {};
+                const size_t value {objectEntry(patch, patchLength, pos, key)};
+                const size_t end {value != 0 ? skipValue(patch, patchLength, value) : 0};
+                if (end == 0) {
+                    return false;
+                }
+                const StringView name {patch + key.offset, key.length};
+                const bool added {!targetObject || findEntry(target, targetLength, targetPos, name) == 0};
+                if (added && patch[value] != 'n' && findEntry(patch, patchLength, patchPos, name) == value) {
+                    writeEntryName(out, patch, key, first);
+                    if (!mergeValue(out, target, targetLength, noTarget, patch, patchLength, value)) {
+                        return false;
+                    }
+                }
+                pos = nextItem(patch, patchLength, end, '}', done);
+                if (pos == 0) {
+                    return false;
+                }
+            }
+            out.put('}');
+            return true;
+        }
+    } // namespace priv
+
+    ///
+    /// Applies the merge patch to the target document, into buffer; works at compile time and at runtime.
+    /// Entries are matched by their raw names, values which are not patched are copied verbatim and the rest is compact.
+    /// @return length of the merged document, larger than capacity if the buffer was too small; 0 if either document is malformed
+    ///
+    constexpr size_t mergePatchJSON(const char *target, size_t targetLength, const char *patch, size_t patchLength, char *buffer, size_t capacity) noexcept
+    {
+        const size_t targetPos {skipWhitespace(target, targetLength, 0)};
+        const size_t patchPos {skipWhitespace(patch, patchLength, 0)};
+        const size_t targetEnd {priv::skipValue(target, targetLength, targetPos)};
+        const size_t patchEnd {priv::skipValue(patch, patchLength, patchPos)};
+        if (targetEnd == 0 || patchEnd == 0 || skipWhitespace(target, targetLength, targetEnd) != targetLength
+            || skipWhitespace(patch, patchLength, patchEnd) != patchLength) {
+            return 0;
+        }
+        priv::JSONOutput out {buffer, capacity};
+        return priv::mergeValue(out, target, targetLength, targetPos, patch, patchLength, patchPos) ? out.size() : 0;
+    }
+
+    namespace priv
+    {
+        template <const char *target, const char *patch>
+        constexpr size_t mergedLength {mergePatchJSON(target, textLength(target), patch, textLength(patch), nullptr, 0)};
+
+        template <const char *target, const char *patch>
+        constexpr std::array<char, mergedLength<target, patch> + 1> mergeTexts() noexcept
+        {
+            std::array<char, mergedLength<target, patch> + 1> result {};
+            mergePatchJSON(target, textLength(target), patch, textLength(patch), result.data(), mergedLength<target, patch>);
+            return result;
+        }
+
+        template <const char *target, const char *patch>
+        constexpr std::array<char, mergedLength<target, patch> + 1> mergedText {mergeTexts<target, patch>()};
+    } // namespace priv
+
+    ///
+    /// Merge patch of two '\0' terminated constexpr documents, text is the merged document and Input its String for JSONParser.
+    /// Layers stack by merging into text: JSONMergePatch<JSONMergePatch<base, staging>::text, local>.
+    ///
+    template <const char *target, const char *patch, typename = std::make_index_sequence<priv::mergedLength<target, patch>>>
+    struct JSONMergePatch;
+
+    template <const char *target, const char *patch, size_t... I>
+    struct JSONMergePatch<target, patch, std::index_sequence<I...>>
+    {
+        static_assert(sizeof...(I) != 0, "target or patch is not a well formed JSON document");
+
+        static constexpr char text[] {priv::mergedText<target, patch>[I]..., '\0'};
+        using Input = String<text, 0, sizeof...(I)>;
+    };
+} // namespace ctjson
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "CTJson.h"
+#include "Tokenizer.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+///
+/// On-demand access to runtime JSON text, for reading a few values of a large document without building a DOM
+///
+namespace ctjson
+{
+    ///
+    /// Position of a value in JSON text, nothing is parsed until the value is looked into.
+    /// Lookups skip the values in front of the requested one by matching brackets outside of strings,
+    /// so skipped values are not validated; the values on the path and the returned scalar are.
+    /// A lookup which fails gives an invalid value, further lookups on it stay invalid.
+    /// The input buffer has to outlive the values.
+    ///
+    class JSONLazyValue
+    {
+    public:
+        JSONLazyValue() noexcept = default;
+
+        JSONLazyValue(const char *str, size_t length) noexcept
+            : JSONLazyValue(str, length, skipWhitespace(str, length, 0))
+        {
+        }
+
+        explicit JSONLazyValue(const std::string &str) noexcept
+            : JSONLazyValue(str.data(), str.size())
+        {
+        }
+
+        bool valid() const noexcept
+        {
+            return input_ != nullptr;
+        }
+
+        /// @return type of the first token of the value, TokenType::Invalid if the value is invalid or malformed
+        TokenType type() const noexcept
+        {
+            return valid() ? classifyToken(input_, length_, pos_).type : TokenType::Invalid;
+        }
+
+        /// @return value of the first entry of an object with this name, including the quotes as in JSONNode::find
+        template <size_t N>
+        JSONLazyValue operator[](const char (&name)[N]) const noexcept
+        {
+            return member(name, N - 1);
+        }
+
+        /// @return value of the entry of an object with this name, including the quotes
+        JSONLazyValue member(const char *name, size_t nameLength) const noexcept
+        {
+            if (!valid() || input_[pos_] != '{') {
+                return {};
+            }
+            size_t pos {skipWhitespace(input_, length_, pos_ + 1)};
+            if (pos < length_ && input_[pos] == '}') {
+                return {};
+            }
+            while (true) {
+                const JSONToken key {pos < length_ ? classifyToken(input_, length_, pos) : JSONToken {}};
+                if (key.type != TokenType::String) {
+                    return {};
+                }
+                pos = skipWhitespace(input_, length_, pos + key.length);
+                if (pos >= length_ || input_[pos] != ':') {
+                    return {};
+                }
+                pos = skipWhitespace(input_, length_, pos + 1);
+                if (key.length == nameLength && std::memcmp(input_ + key.offset, name, nameLength) == 0) {
+                    return {input_, length_, pos};
+                }
+                if (!next(pos)) {
+                    return {};
+                }
+            }
+        }
+
+        /// @return element of an array
+        JSONLazyValue operator[](size_t idx) const noexcept
+        {
+            if (!valid() || input_[pos_] != '[') {
+                return {};
+            }
+            size_t pos {skipWhitespace(input_, length_, pos_ + 1)};
+            if (pos < length_ && input_[pos] == ']') {
+                return {};
+            }
+            for (; idx != 0; --idx) {
+                if (!next(pos)) {
+                    return {};
+                }
+            }
+            return {input_, length_, pos};
+        }
+
+        /// @return the value if it has type T, default value otherwise; integers out of the range of T give the default value too
+        template <typename T>
+        JSONValueWrapper<T> get() const noexcept
+        {
+            const JSONToken token {valid() ? classifyToken(input_, length_, pos_) : JSONToken {}};
+            return priv::tokenValue<T>(token.type, input_ + token.offset, token.length);
+        }
+
+        /// @return text of the whole value, empty if it is invalid or malformed
+        StringView raw() const noexcept
+        {
+            const size_t end {valid() ? priv::skipValue(input_, length_, pos_) : 0};
+            return end != 0 ? StringView(input_ + pos_, end - pos_) : StringView("", 0);
+        }
+
+        /// @return position of the value in the input
+        size_t offset() const noexcept
+        {
+            return pos_;
+        }
+
+    private:
+        JSONLazyValue(const char *str, size_t length, size_t pos) noexcept
+            : input_ {pos < length ? str : nullptr}
+            , length_ {length}
+            , pos_ {pos}
+        {
+        }
+
+        /// moves pos from a value of the current container to the next one
+        /// @return false if the value is malformed or was the last one
+        bool next(size_t &pos) const noexcept
+        {
+            const size_t end {priv::skipValue(input_, length_, pos)};
+            if (end == 0) {
+                return false;
+            }
+            pos = skipWhitespace(input_, length_, end);
+            if (pos >= length_ || input_[pos] != ',') {
+                return false;
+            }
+            pos = skipWhitespace(input_, length_, pos + 1);
+            return true;
+        }
+
+        const char *input_ {nullptr};
+        size_t length_ {0};
+        size_t pos_ {0};
+    };
+} // namespace ctjson
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "CTJson.h"
+#include "StringEscapes.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+///
+/// JSON Pointer (RFC 6901) queries into constexpr object trees, resolved at compile time
+///
+namespace ctjson
+{
+    namespace priv
+    {
+        /// Positions taken at each level of a pointer: entry of an object or element of an array
+        struct JSONPointerSteps
+        {
+            static constexpr size_t maxDepth {32};
+
+            bool valid {false};
+            size_t count {0};
+            size_t steps[maxDepth] {};
+        };
+
+        /// @return end of the reference token starting at begin
+        constexpr size_t referenceTokenEnd(const char *pointer, size_t length, size_t begin) noexcept
+        {
+            while (begin < length && pointer[begin] != '/') {
+                ++begin;
+            }
+            return begin;
+        }
+
+        /// @return true if the decoded reference token (~0 is '~', ~1 is '/') equals the decoded content of the name token
+        constexpr bool referenceTokenEquals(const char *pointer, size_t begin, size_t end, const StringView &name) noexcept
+        {
+            constexpr size_t maxNameLength {256};
+            char decoded[maxNameLength] {};
+            const char *content {name.data() + 1};
+            size_t contentLength {name.size() - 2};
+            // names with escapes are compared after decoding them
+            for (size_t i = 0; i < contentLength; ++i) {
+                if (content[i] == '\\') {
+                    if (name.size() > maxNameLength) {
+                        return false;
+                    }
+                    contentLength = unescapeString(name.data(), name.size(), decoded);
+                    content = decoded;
+                    break;
+                }
+            }
+            size_t pos {0};
+            for (size_t i = begin; i < end; ++i, ++pos) {
+                char c {pointer[i]};
+                if (c == '~') {
+                    if (i + 1 == end || (pointer[i + 1] != '0' && pointer[i + 1] != '1')) {
+                        return false;
+                    }
+                    c = (pointer[++i] == '0') ? '~' : '/';
+                }
+                if (pos >= contentLength || content[pos] != c) {
+                    return false;
+                }
+            }
+            return pos == contentLength;
+        }
+
+        /// @return array index of the reference token, npos unless it is a number without leading zeros below size
+        constexpr size_t referenceTokenIndex(const char *pointer, size_t begin, size_t end, size_t size) noexcept
+        {
+            constexpr size_t npos {static_cast<size_t>(-1)};
+            if (begin == end || (pointer[begin] == '0' && end - begin > 1)) {
+                return npos;
+            }
+            size_t index {0};
+            for (size_t i = begin; i < end; ++i) {
+                if (!isDigit(pointer[i]) || index > size) {
+                    return npos;
+                }
+                index = index * 10 + static_cast<size_t>(pointer[i] - '0');
+            }
+            return index < size ? index : npos;
+        }
+
+        template <typename T>
+        constexpr void resolvePointer(const T &value, const char *pointer, size_t length, size_t begin, JSONPointerSteps &result) noexcept;
+
+        /// finds the entry of an object, entries is the key/value chain of a JSONDict or a single JSONObject
+        template <typename T>
+        constexpr void resolveEntry(const T &entries, size_t position, const char *pointer, size_t length, size_t begin, JSONPointerSteps &result) noexcept
+        {
+            const size_t end {referenceTokenEnd(pointer, length, begin)};
+            if constexpr (isJSONDictNode<T>) {
+                if (referenceTokenEquals(pointer, begin, end, entries.node().name())) {
+                    result.steps[result.count++] = position;
+                    resolvePointer(entries.node().value(), pointer, length, end, result);
+                } else {
+                    resolveEntry(entries.next(), position + 1, pointer, length, begin, result);
+                }
+            } else if (referenceTokenEquals(pointer, begin, end, entries.name())) {
+                result.steps[result.count++] = position;
+                resolvePointer(entries.value(), pointer, length, end, result);
+            }
+        }
+
+        /// begin is the position of the '/' which starts the next reference token, or length at the end of the pointer
+        template <typename T>
+        constexpr void resolvePointer(const T &value, const char *pointer, size_t length, size_t begin, JSONPointerSteps &result) noexcept
+        {
+            if (begin == length) {
+                result.valid = true;
+                return;
+            }
+            if (pointer[begin] != '/' || result.count == JSONPointerSteps::maxDepth) {
+                return;
+            }
+            ++begin;
+            if constexpr (isStdArray<T>) {
+                const size_t end {referenceTokenEnd(pointer, length, begin)};
+                const size_t index {referenceTokenIndex(pointer, begin, end, value.size())};
+                if (index != static_cast<size_t>(-1)) {
+                    result.steps[result.count++] = index;
+                    resolvePointer(value[index], pointer, length, end, result);
+                }
+            } else if constexpr (isJSONDict<T>) {
+                resolveEntry(value.entries(), 0, pointer, length, begin, result);
+            } else if constexpr (isJSONObject<T>) {
+                resolveEntry(value, 0, pointer, length, begin, result);
+            }
+        }
+
+        /// value of the entry at position in the key/value chain of a JSONDict
+        template <size_t position>
+        struct JSONEntryAt
+        {
+            template <typename T, typename U>
+            static constexpr const auto &value(const JSONDictNode<T, U> &entries) noexcept
+            {
+                if constexpr (position == 0) {
+                    return entries.node().value();
+                } else {
+                    return JSONEntryAt<position - 1>::value(entries.next());
+                }
+            }
+
+            template <typename T>
+            static constexpr const auto &value(const JSONObject<T> &entry) noexcept
+            {
+                return entry.value();
+            }
+        };
+
+        template <typename T>
+        constexpr JSONPointerSteps computePointerSteps(const T &object, const char *pointer) noexcept
+        {
+            size_t length {0};
+            while (pointer[length] != '\0') {
+                ++length;
+            }
+            JSONPointerSteps result;
+            resolvePointer(object, pointer, length, 0, result);
+            return result;
+        }
+
+        template <const char *pointer, const auto &object>
+        constexpr JSONPointerSteps pointerSteps {computePointerSteps(object, pointer)};
+
+        /// follows the resolved steps from level on, every step is a plain member or element access
+        template <const JSONPointerSteps &path, size_t level, typename T>
+        constexpr const auto &followPointer(const T &value) noexcept
+        {
+            if constexpr (level == path.count) {
+                return value;
+            } else if constexpr (isStdArray<T>) {
+                return followPointer<path, level + 1>(value[path.steps[level]]);
+            } else if constexpr (isJSONDict<T>) {
+                return followPointer<path, level + 1>(JSONEntryAt<path.steps[level]>::value(value.entries()));
+            } else {
+                return followPointer<path, level + 1>(value.value());
+            }
+        }
+    } // namespace priv
+
+    ///
+    /// @return true if the JSON pointer (e.g. "/servers/0/port") refers to a value of the constexpr object tree
+    ///
+    template <const char *pointer, const auto &object>
+    constexpr bool containsPointer {priv::pointerSteps<pointer, object>.valid};
+
+    ///
+    /// @return reference to the value of the constexpr object tree at the JSON pointer (e.g. "/servers/0/port"),
+    /// the path is resolved at compile time to direct member accesses; a pointer which does not match is a compile error.
+    /// The empty pointer refers to the whole tree, names are compared after decoding their escapes.
+    ///
+    template <const char *pointer, const auto &object>
+    constexpr const auto &at() noexcept
+    {
+        static_assert(containsPointer<pointer, object>, "JSON pointer does not refer to a value of the object");
+        if constexpr (containsPointer<pointer, object>) {
+            return priv::followPointer<priv::pointerSteps<pointer, object>, 0>(object);
+        } else {
+            return object;
+        }
+    }
+} // namespace ctjson
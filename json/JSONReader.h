@@ -0,0 +1,401 @@
+#pragma once
+
+#include "CTJson.h"
+#include "Tokenizer.h"
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <type_traits>
+
+///
+/// Streaming reader for JSON text which does not fit in memory
+///
+namespace ctjson
+{
+    ///
+    /// Chunk source reading from a std::istream
+    ///
+    class JSONStreamSource
+    {
+    public:
+        explicit JSONStreamSource(std::istream &stream) noexcept
+            : stream_ {stream}
+        {
+        }
+
+        /// @return number of bytes copied to buffer, 0 at the end of the stream
+        size_t read(char *buffer, size_t capacity)
+        {
+            stream_.read(buffer, static_cast<std::streamsize>(capacity));
+            return static_cast<size_t>(stream_.gcount());
+        }
+
+    private:
+        std::istream &stream_;
+    };
+
+    ///
+    /// Chunk source over a buffer in memory, hands out at most chunkSize bytes per read
+    ///
+    class JSONBufferSource
+    {
+    public:
+        JSONBufferSource(const char *str, size_t length, size_t chunkSize = static_cast<size_t>(-1)) noexcept
+            : input_ {str}
+            , length_ {length}
+            , chunkSize_ {chunkSize}
+        {
+        }
+
+        size_t read(char *buffer, size_t capacity) noexcept
+        {
+            size_t count {length_ - pos_};
+            count = count < capacity ? count : capacity;
+            count = count < chunkSize_ ? count : chunkSize_;
+            std::memcpy(buffer, input_ + pos_, count);
+            pos_ += count;
+            return count;
+        }
+
+    private:
+        const char *input_;
+        size_t length_;
+        size_t chunkSize_;
+        size_t pos_ {0};
+    };
+
+    enum class JSONEventType : uint8_t {
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        Key,
+        String,
+        Number,
+        Boolean,
+        Null,
+        EndDocument,
+        Error
+    };
+
+    ///
+    /// Single event of a JSONReader.
+    /// The text of keys and values (strings keep their quotes) is only valid until the next event is read.
+    ///
+    struct JSONEvent
+    {
+        JSONEventType type {JSONEventType::Error};
+        StringView text;
+        /// position of the token in the stream
+        uint64_t offset {0};
+
+        /// @return the value if it has type T, default value otherwise; integers out of the range of T give the default value too
+        template <typename T>
+        JSONValueWrapper<T> as() const noexcept
+        {
+            TokenType token {TokenType::Invalid};
+            switch (type) {
+            case JSONEventType::Key:
+            case JSONEventType::String:
+                token = TokenType::String;
+                break;
+            case JSONEventType::Number:
+                token = TokenType::Number;
+                break;
+            case JSONEventType::Boolean:
+                token = TokenType::Boolean;
+                break;
+            default:
+                break;
+            }
+            return priv::tokenValue<T>(token, text.data(), text.size());
+        }
+    };
+
+    enum class JSONReaderMode : uint8_t {
+        /// exactly one value, anything but whitespace after it is an error
+        SingleDocument,
+        /// any number of values one after the other, e.g. NDJSON; EndDocument comes at the end of the input
+        MultipleDocuments
+    };
+
+    ///
+    /// Pull parser over a chunked source, Source has to provide size_t read(char *buffer, size_t capacity).
+    /// Memory use is bounded by the chunk size, the longest token and maxDepth, no matter how long the input is.
+    /// Tokens split between chunks are completed with the following reads before they are classified.
+    ///
+    template <typename Source>
+    class JSONReader
+    {
+    public:
+        /// nesting limit, the open containers are tracked with one bit each
+        static constexpr size_t maxDepth {512};
+
+        /// maxTokenLength limits how far the buffer may grow for a single string or number
+        explicit JSONReader(Source &source, size_t chunkSize = 64 * 1024, size_t maxTokenLength = 16 * 1024 * 1024)
+            : source_ {source}
+            , capacity_ {chunkSize != 0 ? chunkSize : 1}
+            , maxCapacity_ {maxTokenLength > capacity_ ? maxTokenLength : capacity_}
+            , buffer_ {new char[capacity_]}
+        {
+        }
+
+        JSONReader(Source &source, JSONReaderMode mode, size_t chunkSize = 64 * 1024, size_t maxTokenLength = 16 * 1024 * 1024)
+            : JSONReader(source, chunkSize, maxTokenLength)
+        {
+            mode_ = mode;
+        }
+
+        /// @return the next event, EndDocument and Error are repeated once reached
+        JSONEvent next()
+        {
+            while (state_ != State::Failed && state_ != State::Finished) {
+                const JSONToken token {readToken()};
+                switch (state_) {
+                case State::FirstElement:
+                    if (token.type == TokenType::ArrayClose) {
+                        return close(token, false);
+                    }
+                    return value(token);
+                case State::Value:
+                    if (depth_ == 0 && mode_ == JSONReaderMode::MultipleDocuments && token.type == TokenType::Invalid && atEnd()) {
+                        state_ = State::Finished;
+                        break;
+                    }
+                    return value(token);
+                case State::FirstKey:
+                    if (token.type == TokenType::DictClose) {
+                        return close(token, true);
+                    }
+                    [[fallthrough]];
+                case State::Key:
+                    if (token.type != TokenType::String) {
+                        return fail(token);
+                    }
+                    state_ = State::Colon;
+                    return event(JSONEventType::Key, token);
+                case State::Colon:
+                    if (token.type != TokenType::Colon) {
+                        return fail(token);
+                    }
+                    state_ = State::Value;
+                    break;
+                case State::AfterValue:
+                    if (token.type == TokenType::Comma) {
+                        state_ = inObject() ? State::Key : State::Value;
+                        break;
+                    }
+                    if (token.type == (inObject() ? TokenType::DictClose : TokenType::ArrayClose)) {
+                        return close(token, inObject());
+                    }
+                    return fail(token);
+                case State::Done:
+                    if (token.type != TokenType::Invalid || !atEnd()) {
+                        return fail(token);
+                    }
+                    state_ = State::Finished;
+                    break;
+                default:
+                    break;
+                }
+            }
+            JSONEvent result;
+            result.type = (state_ == State::Finished) ? JSONEventType::EndDocument : JSONEventType::Error;
+            result.offset = (state_ == State::Finished) ? consumed_ + end_ : errorOffset_;
+            return result;
+        }
+
+        /// push interface, calls handler(event) for every event up to the end of the document (all documents in MultipleDocuments mode)
+        /// @return true if the whole document was read without errors
+        template <typename Handler>
+        bool parse(Handler &&handler)
+        {
+            while (true) {
+                const JSONEvent current {next()};
+                if (current.type == JSONEventType::Error) {
+                    return false;
+                }
+                if (current.type == JSONEventType::EndDocument) {
+                    return true;
+                }
+                handler(current);
+            }
+        }
+
+        /// @return stream offset of the token which could not be parsed
+        uint64_t errorOffset() const noexcept
+        {
+            return errorOffset_;
+        }
+
+        /// @return size of the read buffer
+        size_t memoryUsage() const noexcept
+        {
+            return capacity_;
+        }
+
+    private:
+        enum class State : uint8_t {
+            Value,
+            FirstElement,
+            FirstKey,
+            Key,
+            Colon,
+            AfterValue,
+            Done,
+            Finished,
+            Failed
+        };
+
+        bool inObject() const noexcept
+        {
+            return isObject_[depth_ - 1];
+        }
+
+        bool atEnd() const noexcept
+        {
+            return eof_ && begin_ == end_;
+        }
+
+        /// moves the unread bytes to the front of the buffer and appends the next chunk
+        /// @return false if a single token does not fit in maxTokenLength bytes
+        bool fill()
+        {
+            if (begin_ != 0) {
+                std::memmove(buffer_.get(), buffer_.get() + begin_, end_ - begin_);
+                consumed_ += begin_;
+                end_ -= begin_;
+                begin_ = 0;
+            }
+            if (end_ == capacity_) {
+                if (capacity_ == maxCapacity_) {
+                    return false;
+                }
+                const size_t grown {2 * capacity_ < maxCapacity_ ? 2 * capacity_ : maxCapacity_};
+                std::unique_ptr<char[]> buffer {new char[grown]};
+                std::memcpy(buffer.get(), buffer_.get(), end_);
+                buffer_ = std::move(buffer);
+                capacity_ = grown;
+            }
+            const size_t count {source_.read(buffer_.get() + end_, capacity_ - end_)};
+            eof_ = (count == 0);
+            end_ += count;
+            return true;
+        }
+
+        static bool isDelimiter(char c) noexcept
+        {
+            return isWhitespace(c) || c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',' || c == '"';
+        }
+
+        /// numbers and literals may continue in the next chunk unless a delimiter follows them in the buffer
+        bool isComplete(const JSONToken &token) const noexcept
+        {
+            if (buffer_[begin_] == '"') {
+                return token.type != TokenType::Invalid || findStringEnd(buffer_.get(), end_, begin_) < end_;
+            }
+            for (size_t pos = begin_; pos < end_; ++pos) {
+                if (isDelimiter(buffer_[pos])) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// @return next complete token, its offset is relative to the buffer
+        JSONToken readToken()
+        {
+            while (true) {
+                begin_ = skipWhitespace(buffer_.get(), end_, begin_);
+                if (begin_ == end_) {
+                    if (eof_) {
+                        return { TokenType::Invalid, begin_, 0 };
+                    }
+                    fill();
+                    continue;
+                }
+                const JSONToken token {classifyToken(buffer_.get(), end_, begin_)};
+                if (eof_ || isComplete(token)) {
+                    begin_ += token.length;
+                    return token;
+                }
+                if (!fill()) {
+                    return { TokenType::Invalid, begin_, 0 };
+                }
+            }
+        }
+
+        JSONEvent event(JSONEventType type, const JSONToken &token) const noexcept
+        {
+            JSONEvent result;
+            result.type = type;
+            result.text = StringView(buffer_.get() + token.offset, token.length);
+            result.offset = consumed_ + token.offset;
+            return result;
+        }
+
+        JSONEvent fail(const JSONToken &token) noexcept
+        {
+            state_ = State::Failed;
+            errorOffset_ = consumed_ + token.offset;
+            return next();
+        }
+
+        JSONEvent value(const JSONToken &token) noexcept
+        {
+            switch (token.type) {
+            case TokenType::String:
+                return afterValue(event(JSONEventType::String, token));
+            case TokenType::Number:
+                return afterValue(event(JSONEventType::Number, token));
+            case TokenType::Boolean:
+                return afterValue(event(JSONEventType::Boolean, token));
+            case TokenType::Null:
+                return afterValue(event(JSONEventType::Null, token));
+            case TokenType::DictOpen:
+            case TokenType::ArrayOpen:
+                if (depth_ == maxDepth) {
+                    return fail(token);
+                }
+                isObject_[depth_++] = (token.type == TokenType::DictOpen);
+                state_ = (token.type == TokenType::DictOpen) ? State::FirstKey : State::FirstElement;
+                return event(token.type == TokenType::DictOpen ? JSONEventType::StartObject : JSONEventType::StartArray, token);
+            default:
+                return fail(token);
+            }
+        }
+
+        JSONEvent close(const JSONToken &token, bool isObject) noexcept
+        {
+            --depth_;
+            return afterValue(event(isObject ? JSONEventType::EndObject : JSONEventType::EndArray, token));
+        }
+
+        JSONEvent afterValue(const JSONEvent &result) noexcept
+        {
+            if (depth_ != 0) {
+                state_ = State::AfterValue;
+            } else {
+                state_ = (mode_ == JSONReaderMode::MultipleDocuments) ? State::Value : State::Done;
+            }
+            return result;
+        }
+
+        Source &source_;
+        size_t capacity_;
+        size_t maxCapacity_;
+        std::unique_ptr<char[]> buffer_;
+        size_t begin_ {0};
+        size_t end_ {0};
+        /// stream offset of the first byte in the buffer
+        uint64_t consumed_ {0};
+        bool eof_ {false};
+        State state_ {State::Value};
+        JSONReaderMode mode_ {JSONReaderMode::SingleDocument};
+        std::bitset<maxDepth> isObject_;
+        size_t depth_ {0};
+        uint64_t errorOffset_ {0};
+    };
+} // namespace ctjson
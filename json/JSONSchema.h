@@ -0,0 +1,672 @@
+#pragma once
+
+#include "NumberUtils.h"
+#include "StringEscapes.h"
+#include "StringUtils.h"
+#include "Tokenizer.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+///
+/// Validation against a subset of JSON Schema: "type", "properties", "required", "items", "minimum", "maximum" and "enum".
+/// The schema is compiled at compile time into flat tables, which validate documents at compile time and at runtime.
+///
+namespace ctjson
+{
+    enum class JSONValidationError : uint8_t {
+        None,
+        /// the document is not well formed JSON
+        Syntax,
+        Type,
+        /// a required entry is missing, the path ends with its name
+        Required,
+        Minimum,
+        Maximum,
+        Enum,
+        /// nesting deeper than maxValidationDepth
+        Depth,
+        /// the schema itself was not compiled
+        Schema
+    };
+
+    /// nesting limit of validated documents, deeper input is rejected instead of exhausting the stack
+    constexpr size_t maxValidationDepth {512};
+
+    ///
+    /// Outcome of a validation: the first violation, its byte offset and the JSON Pointer of the offending value
+    ///
+    struct JSONValidationResult
+    {
+        static constexpr size_t maxPathLength {256};
+
+        JSONValidationError error {JSONValidationError::None};
+        size_t offset {0};
+        /// longer paths are cut off
+        size_t pathLength {0};
+        char path[maxPathLength] {};
+
+        constexpr bool valid() const noexcept
+        {
+            return error == JSONValidationError::None;
+        }
+    };
+
+    namespace priv
+    {
+        constexpr size_t noSchema {static_cast<size_t>(-1)};
+
+        constexpr uint8_t schemaObject {1};
+        constexpr uint8_t schemaArray {2};
+        constexpr uint8_t schemaString {4};
+        constexpr uint8_t schemaNumber {8};
+        constexpr uint8_t schemaInteger {16};
+        constexpr uint8_t schemaBoolean {32};
+        constexpr uint8_t schemaNull {64};
+
+        /// @return bit of a type name token, 0 if it is unknown
+        constexpr uint8_t schemaTypeBit(const StringView &name) noexcept
+        {
+            return name.equals("\"object\"") ? schemaObject
+                : name.equals("\"array\"") ? schemaArray
+                : name.equals("\"string\"") ? schemaString
+                : name.equals("\"number\"") ? schemaNumber
+                : name.equals("\"integer\"") ? schemaInteger
+                : name.equals("\"boolean\"") ? schemaBoolean
+                : name.equals("\"null\"") ? schemaNull
+                : 0;
+        }
+
+        /// Rules of one (sub)schema, properties and enum values are ranges of the tables of JSONSchema
+        struct JSONSchemaNode
+        {
+            /// one bit per accepted type, 0 accepts all of them
+            uint8_t types {0};
+            bool hasMinimum {false};
+            bool hasMaximum {false};
+            double minimum {0.0};
+            double maximum {0.0};
+            size_t firstProperty {0};
+            size_t propertyCount {0};
+            size_t items {noSchema};
+            size_t firstEnum {0};
+            size_t enumCount {0};
+        };
+
+        /// Entry of "properties" or "required", the name keeps its quotes
+        struct JSONSchemaProperty
+        {
+            StringView name;
+            size_t node {noSchema};
+            bool required {false};
+        };
+    } // namespace priv
+
+    ///
+    /// Compiled schema, node 0 is the root. Every table is sized by the token count of the schema text.
+    ///
+    template <size_t capacity>
+    struct JSONSchema
+    {
+        bool valid {false};
+        /// position of the first unsupported or malformed part of the schema text
+        size_t errorOffset {0};
+        size_t nodeCount {0};
+        size_t propertyCount {0};
+        size_t enumCount {0};
+        std::array<priv::JSONSchemaNode, capacity> nodes {};
+        std::array<priv::JSONSchemaProperty, capacity> properties {};
+        /// scalar tokens of "enum"
+        std::array<StringView, capacity> enums {};
+    };
+
+    namespace priv
+    {
+        /// integers beyond the int64_t range are read as doubles, parseInt64 would wrap them around
+        constexpr double numberValue(const char *str, size_t length) noexcept
+        {
+            if (isIntegerNumber(str, length)) {
+                const IntegerRange range {integerRange(str, length)};
+                if (range == IntegerRange::Int32 || range == IntegerRange::Int64) {
+                    return static_cast<double>(parseInt64(str, length));
+                }
+            }
+            return parseDouble(str, length);
+        }
+
+        /// @return number of items of the object or array at pos, npos if it is malformed
+        constexpr size_t countItems(const char *str, size_t length, size_t pos) noexcept
+        {
+            constexpr size_t npos {static_cast<size_t>(-1)};
+            if (str[pos] != '{' && str[pos] != '[') {
+                return npos;
+            }
+            const bool object {str[pos] == '{'};
+            const char close {object ? '}' : ']'};
+            bool done {false};
+            size_t count {0};
+            for (pos = firstItem(str, length, pos, close, done); !done; ++count) {
+                JSONToken key {};
+                const size_t value {object ? objectEntry(str, length, pos, key) : pos};
+                const size_t end {skipValue(str, length, value)};
+                pos = (value != 0 && end != 0) ? nextItem(str, length, end, close, done) : 0;
+                if (pos == 0) {
+                    return npos;
+                }
+            }
+            return count;
+        }
+
+        template <size_t capacity>
+        constexpr size_t schemaError(JSONSchema<capacity> &schema, size_t pos) noexcept
+        {
+            schema.errorOffset = pos;
+            return 0;
+        }
+
+        template <size_t capacity>
+        constexpr size_t compileSchemaNode(JSONSchema<capacity> &schema, const char *str, size_t length, size_t pos, size_t &index) noexcept;
+
+        /// "type": a name or an array of names
+        template <size_t capacity>
+        constexpr bool compileSchemaType(JSONSchema<capacity> &schema, const char *str, size_t length, size_t pos, size_t index) noexcept
+        {
+            const bool list {str[pos] == '['};
+            bool done {false};
+            size_t next {list ? firstItem(str, length, pos, ']', done) : pos};
+            if (done) {
+                // an empty list would reject everything
+                schemaError(schema, pos);
+                return false;
+            }
+            while (!done) {
+                const JSONToken name {classifyToken(str, length, next)};
+                const uint8_t bit {name.type == TokenType::String ? schemaTypeBit(StringView(str + next, name.length)) : uint8_t {0}};
+                if (bit == 0) {
+                    schemaError(schema, next);
+                    return false;
+                }
+                schema.nodes[index].types |= bit;
+                if (!list) {
+                    return true;
+                }
+                const size_t end {next + name.length};
+                next = nextItem(str, length, end, ']', done);
+                if (next == 0) {
+                    schemaError(schema, end);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// "properties": every subschema is compiled into the slots reserved for the node
+        template <size_t capacity>
+        constexpr bool compileSchemaProperties(JSONSchema<capacity> &schema, const char *str, size_t length, size_t pos, size_t index) noexcept
+        {
+            bool done {false};
+            for (pos = firstItem(str, length, pos, '}', done); !done;) {
+                JSONToken key {};
+                const size_t value {objectEntry(str, length, pos, key)};
+                size_t child {noSchema};
+                const size_t end {compileSchemaNode(schema, str, length, value, child)};
+                if (end == 0) {
+                    return false;
+                }
+                JSONSchemaNode &node {schema.nodes[index]};
+                schema.properties[node.firstProperty + node.propertyCount++] = {StringView(str + key.offset, key.length), child, false};
+                pos = nextItem(str, length, end, '}', done);
+            }
+            return true;
+        }
+
+        /// "required": names missing in "properties" get slots of their own which accept any value
+        template <size_t capacity>
+        constexpr bool compileSchemaRequired(JSONSchema<capacity> &schema, const char *str, size_t length, size_t pos, size_t index) noexcept
+        {
+            if (str[pos] != '[') {
+                schemaError(schema, pos);
+                return false;
+            }
+            JSONSchemaNode &node {schema.nodes[index]};
+            bool done {false};
+            for (pos = firstItem(str, length, pos, ']', done); !done;) {
+                const JSONToken name {classifyToken(str, length, pos)};
+                if (name.type != TokenType::String) {
+                    schemaError(schema, pos);
+                    return false;
+                }
+                const StringView required {str + pos, name.length};
+                size_t slot {0};
+                while (slot < node.propertyCount && !schema.properties[node.firstProperty + slot].name.equals(required)) {
+                    ++slot;
+                }
+                if (slot == node.propertyCount) {
+                    schema.properties[node.firstProperty + node.propertyCount++] = {required, noSchema, true};
+                }
+                // presence of required entries is tracked in a 64-bit mask
+                if (slot >= 64) {
+                    schemaError(schema, pos);
+                    return false;
+                }
+                schema.properties[node.firstProperty + slot].required = true;
+                pos = nextItem(str, length, pos + name.length, ']', done);
+            }
+            return true;
+        }
+
+        /// "enum": scalars only
+        template <size_t capacity>
+        constexpr bool compileSchemaEnum(JSONSchema<capacity> &schema, const char *str, size_t length, size_t pos, size_t index) noexcept
+        {
+            schema.nodes[index].firstEnum = schema.enumCount;
+            bool done {str[pos] != '['};
+            for (pos = done ? pos : firstItem(str, length, pos, ']', done); !done;) {
+                const JSONToken value {classifyToken(str, length, pos)};
+                if (value.type > TokenType::Null || schema.enumCount == capacity) {
+                    break;
+                }
+                schema.enums[schema.enumCount++] = StringView(str + pos, value.length);
+                ++schema.nodes[index].enumCount;
+                const size_t next {nextItem(str, length, pos + value.length, ']', done)};
+                if (next == 0) {
+                    break;
+                }
+                pos = next;
+            }
+            // a list of scalars which is not empty
+            if (!done || schema.nodes[index].enumCount == 0) {
+                schemaError(schema, pos);
+                return false;
+            }
+            return true;
+        }
+
+        /// compiles the schema object at pos into a new node
+        /// @return end of the schema object, 0 if it is malformed or uses an unsupported keyword
+        template <size_t capacity>
+        constexpr size_t compileSchemaNode(JSONSchema<capacity> &schema, const char *str, size_t length, size_t pos, size_t &index) noexcept
+        {
+            pos = skipWhitespace(str, length, pos);
+            if (pos >= length || str[pos] != '{' || schema.nodeCount == capacity) {
+                return schemaError(schema, pos);
+            }
+            index = schema.nodeCount++;
+
+            // first pass: syntax, and the slots for "properties" and "required" which have to be contiguous
+            size_t slots {0};
+            size_t required {0};
+            bool done {false};
+            size_t end {firstItem(str, length, pos, '}', done)};
+            while (!done) {
+                JSONToken key {};
+                const size_t value {objectEntry(str, length, end, key)};
+                const size_t valueEnd {value != 0 ? skipValue(str, length, value) : 0};
+                if (valueEnd == 0) {
+                    return schemaError(schema, value != 0 ? value : end);
+                }
+                const StringView name {str + key.offset, key.length};
+                if (name.equals("\"properties\"") || name.equals("\"required\"")) {
+                    const size_t count {countItems(str, length, value)};
+                    if (count == static_cast<size_t>(-1)) {
+                        return schemaError(schema, value);
+                    }
+                    slots += count;
+                    required = name.equals("\"required\"") ? value : required;
+                }
+                end = nextItem(str, length, valueEnd, '}', done);
+                if (end == 0) {
+                    return schemaError(schema, valueEnd);
+                }
+            }
+            if (slots > capacity - schema.propertyCount) {
+                return schemaError(schema, pos);
+            }
+            schema.nodes[index].firstProperty = schema.propertyCount;
+            schema.propertyCount += slots;
+
+            // second pass: keywords; "required" refers to the slots of "properties", so it comes last
+            done = false;
+            for (size_t next = firstItem(str, length, pos, '}', done); !done;) {
+                JSONToken key {};
+                const size_t value {objectEntry(str, length, next, key)};
+                const StringView name {str + key.offset, key.length};
+                const JSONToken token {classifyToken(str, length, value)};
+                bool compiled {true};
+                if (name.equals("\"type\"")) {
+                    compiled = compileSchemaType(schema, str, length, value, index);
+                } else if (name.equals("\"properties\"")) {
+                    if (token.type != TokenType::DictOpen) {
+                        return schemaError(schema, value);
+                    }
+                    compiled = compileSchemaProperties(schema, str, length, value, index);
+                } else if (name.equals("\"items\"")) {
+                    size_t items {noSchema};
+                    compiled = compileSchemaNode(schema, str, length, value, items) != 0;
+                    schema.nodes[index].items = items;
+                } else if (name.equals("\"minimum\"") || name.equals("\"maximum\"")) {
+                    if (token.type != TokenType::Number) {
+                        return schemaError(schema, value);
+                    }
+                    const bool minimum {name.equals("\"minimum\"")};
+                    (minimum ? schema.nodes[index].hasMinimum : schema.nodes[index].hasMaximum) = true;
+                    (minimum ? schema.nodes[index].minimum : schema.nodes[index].maximum) = numberValue(str + value, token.length);
+                } else if (name.equals("\"enum\"")) {
+                    compiled = compileSchemaEnum(schema, str, length, value, index);
+                } else if (!name.equals("\"required\"") && !name.equals("\"$schema\"") && !name.equals("\"$id\"") && !name.equals("\"title\"")
+                    && !name.equals("\"description\"")) {
+                    return schemaError(schema, next);
+                }
+                if (!compiled) {
+                    return 0;
+                }
+                next = nextItem(str, length, skipValue(str, length, value), '}', done);
+            }
+            if (required != 0 && !compileSchemaRequired(schema, str, length, required, index)) {
+                return 0;
+            }
+            return end;
+        }
+
+        template <size_t capacity>
+        constexpr JSONSchema<capacity> compileSchemaText(const char *str, size_t length) noexcept
+        {
+            JSONSchema<capacity> schema;
+            size_t root {noSchema};
+            const size_t end {compileSchemaNode(schema, str, length, 0, root)};
+            if (end != 0 && skipWhitespace(str, length, end) != length) {
+                schemaError(schema, end);
+            } else {
+                schema.valid = (end != 0);
+            }
+            return schema;
+        }
+
+        constexpr size_t validationError(JSONValidationResult &result, JSONValidationError error, size_t pos) noexcept
+        {
+            result.error = error;
+            result.offset = pos;
+            return 0;
+        }
+
+        /// Reference token of the JSON Pointer of a violation, with its leading '/'
+        struct JSONPathComponent
+        {
+            char text[JSONValidationResult::maxPathLength] {};
+            size_t length {0};
+
+            constexpr void put(char c) noexcept
+            {
+                if (length < JSONValidationResult::maxPathLength) {
+                    text[length++] = c;
+                }
+            }
+        };
+
+        /// @return "/name" with '~' and '/' escaped as in JSON Pointer, name is a string token
+        constexpr JSONPathComponent pathName(const char *name, size_t length) noexcept
+        {
+            char decoded[JSONValidationResult::maxPathLength] {};
+            size_t decodedLength {0};
+            if (length <= JSONValidationResult::maxPathLength) {
+                decodedLength = unescapeString(name, length, decoded);
+            }
+            JSONPathComponent component;
+            component.put('/');
+            for (size_t i = 0; i < decodedLength; ++i) {
+                if (decoded[i] == '~' || decoded[i] == '/') {
+                    component.put('~');
+                    component.put(decoded[i] == '~' ? '0' : '1');
+                } else {
+                    component.put(decoded[i]);
+                }
+            }
+            return component;
+        }
+
+        constexpr JSONPathComponent pathIndex(size_t index) noexcept
+        {
+            char digits[maxNumberLength] {};
+            const size_t count {formatInteger(static_cast<int64_t>(index), digits)};
+            JSONPathComponent component;
+            component.put('/');
+            for (size_t i = 0; i < count; ++i) {
+                component.put(digits[i]);
+            }
+            return component;
+        }
+
+        /// the path is built only for a violation, while returning from the nested values; the end of a long path is cut off
+        constexpr void prependPath(JSONValidationResult &result, const JSONPathComponent &component) noexcept
+        {
+            constexpr size_t maxLength {JSONValidationResult::maxPathLength};
+            const size_t shift {component.length};
+            const size_t length {result.pathLength + shift < maxLength ? result.pathLength + shift : maxLength};
+            for (size_t i = length; i > shift; --i) {
+                result.path[i - 1] = result.path[i - 1 - shift];
+            }
+            for (size_t i = 0; i < shift; ++i) {
+                result.path[i] = component.text[i];
+            }
+            result.pathLength = length;
+        }
+
+        /// @return true if the scalar token equals one of the enum values, numbers are compared by value
+        template <size_t capacity>
+        constexpr bool matchesEnum(const JSONSchema<capacity> &schema, const JSONSchemaNode &node, const char *str, const JSONToken &token) noexcept
+        {
+            const StringView value {str + token.offset, token.length};
+            for (size_t i = node.firstEnum; i < node.firstEnum + node.enumCount; ++i) {
+                const StringView &candidate {schema.enums[i]};
+                if (token.type == TokenType::Number && (candidate.data()[0] == '-' || isDigit(candidate.data()[0]))) {
+                    if (numberValue(value.data(), value.size()) == numberValue(candidate.data(), candidate.size())) {
+                        return true;
+                    }
+                } else if (candidate.equals(value)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <size_t capacity>
+        constexpr size_t validateValue(const JSONSchema<capacity> &schema, size_t node, const char *str, size_t length, size_t pos, size_t depth,
+            JSONValidationResult &result) noexcept;
+
+        template <size_t capacity>
+        constexpr size_t validateObject(const JSONSchema<capacity> &schema, size_t node, const char *str, size_t length, size_t pos, size_t depth,
+            JSONValidationResult &result) noexcept
+        {
+            const JSONSchemaNode *rules {node != noSchema ? &schema.nodes[node] : nullptr};
+            uint64_t seen {0};
+            const size_t open {pos};
+            bool done {false};
+            for (pos = firstItem(str, length, pos, '}', done); !done;) {
+                JSONToken key {};
+                const size_t value {objectEntry(str, length, pos, key)};
+                if (value == 0) {
+                    return validationError(result, JSONValidationError::Syntax, pos < length ? pos : length);
+                }
+                size_t child {noSchema};
+                for (size_t slot = 0; rules != nullptr && slot < rules->propertyCount; ++slot) {
+                    const JSONSchemaProperty &property {schema.properties[rules->firstProperty + slot]};
+                    if (property.name.equals(StringView(str + key.offset, key.length))) {
+                        child = property.node;
+                        seen |= property.required ? (uint64_t(1) << slot) : 0;
+                        break;
+                    }
+                }
+                const size_t end {validateValue(schema, child, str, length, value, depth + 1, result)};
+                if (end == 0) {
+                    prependPath(result, pathName(str + key.offset, key.length));
+                    return 0;
+                }
+                pos = nextItem(str, length, end, '}', done);
+                if (pos == 0) {
+                    return validationError(result, JSONValidationError::Syntax, skipWhitespace(str, length, end));
+                }
+            }
+            for (size_t slot = 0; rules != nullptr && slot < rules->propertyCount; ++slot) {
+                const JSONSchemaProperty &property {schema.properties[rules->firstProperty + slot]};
+                if (property.required && (seen & (uint64_t(1) << slot)) == 0) {
+                    prependPath(result, pathName(property.name.data(), property.name.size()));
+                    return validationError(result, JSONValidationError::Required, open);
+                }
+            }
+            return pos;
+        }
+
+        template <size_t capacity>
+        constexpr size_t validateArray(const JSONSchema<capacity> &schema, size_t node, const char *str, size_t length, size_t pos, size_t depth,
+            JSONValidationResult &result) noexcept
+        {
+            const size_t items {node != noSchema ? schema.nodes[node].items : noSchema};
+            bool done {false};
+            size_t index {0};
+            for (pos = firstItem(str, length, pos, ']', done); !done; ++index) {
+                const size_t end {validateValue(schema, items, str, length, pos, depth + 1, result)};
+                if (end == 0) {
+                    prependPath(result, pathIndex(index));
+                    return 0;
+                }
+                pos = nextItem(str, length, end, ']', done);
+                if (pos == 0) {
+                    return validationError(result, JSONValidationError::Syntax, skipWhitespace(str, length, end));
+                }
+            }
+            return pos;
+        }
+
+        /// validates the value at pos against a node, noSchema accepts any well formed value
+        /// @return end of the value, 0 with the error recorded in result
+        template <size_t capacity>
+        constexpr size_t validateValue(const JSONSchema<capacity> &schema, size_t node, const char *str, size_t length, size_t pos, size_t depth,
+            JSONValidationResult &result) noexcept
+        {
+            pos = skipWhitespace(str, length, pos);
+            if (pos >= length) {
+                return validationError(result, JSONValidationError::Syntax, length);
+            }
+            const JSONToken token {classifyToken(str, length, pos)};
+            uint8_t type {0};
+            switch (token.type) {
+            case TokenType::DictOpen:
+                type = schemaObject;
+                break;
+            case TokenType::ArrayOpen:
+                type = schemaArray;
+                break;
+            case TokenType::String:
+                type = schemaString;
+                break;
+            case TokenType::Number:
+                type = isIntegerNumber(str + pos, token.length) ? (schemaNumber | schemaInteger) : schemaNumber;
+                break;
+            case TokenType::Boolean:
+                type = schemaBoolean;
+                break;
+            case TokenType::Null:
+                type = schemaNull;
+                break;
+            default:
+                return validationError(result, JSONValidationError::Syntax, pos);
+            }
+            if (node != noSchema) {
+                const JSONSchemaNode &rules {schema.nodes[node]};
+                if (rules.types != 0 && (rules.types & type) == 0) {
+                    return validationError(result, JSONValidationError::Type, pos);
+                }
+                if (rules.enumCount != 0 && (type <= schemaArray || !matchesEnum(schema, rules, str, token))) {
+                    return validationError(result, JSONValidationError::Enum, pos);
+                }
+                if (token.type == TokenType::Number && (rules.hasMinimum || rules.hasMaximum)) {
+                    const double value {numberValue(str + pos, token.length)};
+                    if (rules.hasMinimum && value < rules.minimum) {
+                        return validationError(result, JSONValidationError::Minimum, pos);
+                    }
+                    if (rules.hasMaximum && value > rules.maximum) {
+                        return validationError(result, JSONValidationError::Maximum, pos);
+                    }
+                }
+            }
+            if (type <= schemaArray && depth == maxValidationDepth) {
+                return validationError(result, JSONValidationError::Depth, pos);
+            }
+            if (type == schemaObject) {
+                return validateObject(schema, node, str, length, pos, depth, result);
+            }
+            if (type == schemaArray) {
+                return validateArray(schema, node, str, length, pos, depth, result);
+            }
+            return pos + token.length;
+        }
+    } // namespace priv
+
+    ///
+    /// Validates a whole document, at compile time or at runtime; stops at the first violation.
+    /// "integer" accepts numbers without fraction and exponent, entries not listed in "properties" may have any value.
+    ///
+    template <size_t capacity>
+    constexpr JSONValidationResult validateJSON(const JSONSchema<capacity> &schema, const char *str, size_t length) noexcept
+    {
+        JSONValidationResult result;
+        if (!schema.valid) {
+            priv::validationError(result, JSONValidationError::Schema, 0);
+            return result;
+        }
+        const size_t end {priv::validateValue(schema, 0, str, length, 0, 0, result)};
+        if (end != 0 && skipWhitespace(str, length, end) != length) {
+            priv::validationError(result, JSONValidationError::Syntax, skipWhitespace(str, length, end));
+        }
+        return result;
+    }
+
+    ///
+    /// @return schema compiled from the JSON text, a malformed schema or an unsupported keyword is a compile error
+    ///
+    template <const char *text>
+    constexpr auto compileSchema() noexcept
+    {
+        constexpr size_t length {priv::textLength(text)};
+        constexpr JSONSchema<countTokens(text, length)> schema {priv::compileSchemaText<countTokens(text, length)>(text, length)};
+        static_assert(schema.valid, "schema is malformed or uses an unsupported keyword, see JSONSchema::errorOffset");
+        return schema;
+    }
+
+    ///
+    /// Instantiated for a document which does not match its schema, the template arguments name
+    /// the error, the byte offset and the characters of the JSON Pointer of the offending value
+    ///
+    template <JSONValidationError error, size_t offset, char... path>
+    struct JSONSchemaViolation
+    {
+        static_assert(error == JSONValidationError::None, "document does not match the schema, see the arguments of JSONSchemaViolation: error, byte offset, path");
+        static constexpr bool value {false};
+    };
+
+    namespace priv
+    {
+        template <const auto &schema, const char *document>
+        constexpr JSONValidationResult schemaValidation {validateJSON(schema, document, textLength(document))};
+
+        template <const JSONValidationResult &result, size_t... I>
+        constexpr bool reportViolation(std::index_sequence<I...>) noexcept
+        {
+            return JSONSchemaViolation<result.error, result.offset, result.path[I]...>::value;
+        }
+    } // namespace priv
+
+    ///
+    /// @return true if the '\0' terminated document matches the compiled schema; a mismatch is a compile error
+    /// which shows the kind of violation, its byte offset and the JSON Pointer of the value
+    ///
+    template <const auto &schema, const char *document>
+    constexpr bool checkSchema() noexcept
+    {
+        if constexpr (!priv::schemaValidation<schema, document>.valid()) {
+            return priv::reportViolation<priv::schemaValidation<schema, document>>(std::make_index_sequence<priv::schemaValidation<schema, document>.pathLength>());
+        }
+        return priv::schemaValidation<schema, document>.valid();
+    }
+} // namespace ctjson
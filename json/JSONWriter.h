@@ -0,0 +1,309 @@
+#pragma once
+
+#include "CTJson.h"
+#include "JSONBinding.h"
+#include "NumberUtils.h"
+#include "StringEscapes.h"
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+///
+/// Serialization of object trees and bound structs, at compile time and into caller supplied buffers
+///
+namespace ctjson
+{
+    namespace priv
+    {
+        ///
+        /// Output position of a serializer, bytes past the capacity are counted but not written
+        ///
+        class JSONOutput
+        {
+        public:
+            constexpr JSONOutput(char *buffer, size_t capacity) noexcept
+                : buffer_ {buffer}
+                , capacity_ {capacity}
+            {
+            }
+
+            constexpr void put(char c) noexcept
+            {
+                if (size_ < capacity_) {
+                    buffer_[size_] = c;
+                }
+                ++size_;
+            }
+
+            constexpr void write(const char *str, size_t length) noexcept
+            {
+                const size_t fits {size_ < capacity_ ? (capacity_ - size_ < length ? capacity_ - size_ : length) : 0};
+                if (isConstantEvaluated()) {
+                    for (size_t i = 0; i < fits; ++i) {
+                        buffer_[size_ + i] = str[i];
+                    }
+                } else if (fits != 0) {
+                    std::memcpy(buffer_ + size_, str, fits);
+                }
+                size_ += length;
+            }
+
+            /// writes text as a string token, escaping it; a string which does not fit is only counted
+            constexpr void writeString(const char *str, size_t length) noexcept
+            {
+                put('"');
+                // every byte takes at most six when escaped, so a single pass suffices if that much space is left
+                const bool roomy {size_ < capacity_ && capacity_ - size_ >= 6 * length};
+                const size_t escaped {escapeString(str, length, roomy ? buffer_ + size_ : nullptr)};
+                if (!roomy && size_ + escaped <= capacity_) {
+                    escapeString(str, length, buffer_ + size_);
+                }
+                size_ += escaped;
+                put('"');
+            }
+
+            constexpr size_t size() const noexcept
+            {
+                return size_;
+            }
+
+        private:
+            char *buffer_;
+            size_t capacity_;
+            size_t size_ {0};
+        };
+
+        constexpr void writeNumber(JSONOutput &out, double value) noexcept
+        {
+            char digits[maxNumberLength] {};
+            size_t length {0};
+            if (isConstantEvaluated()) {
+                length = formatDouble(value, digits);
+            } else if (value - value == 0) {
+                length = static_cast<size_t>(std::to_chars(digits, digits + maxNumberLength, value).ptr - digits);
+            }
+            // infinity and NaN have no JSON representation
+            if (length == 0) {
+                out.write("null", 4);
+            } else {
+                out.write(digits, length);
+            }
+        }
+
+        template <typename T>
+        constexpr void writeValue(JSONOutput &out, const T &value) noexcept;
+
+        template <typename T>
+        constexpr void writeEntries(JSONOutput &out, const JSONObject<T> &object) noexcept
+        {
+            out.write(object.name().data(), object.name().size());
+            out.put(':');
+            writeValue(out, object.value());
+        }
+
+        template <typename T, typename U>
+        constexpr void writeEntries(JSONOutput &out, const JSONDictNode<T, U> &entries) noexcept
+        {
+            writeEntries(out, entries.node());
+            out.put(',');
+            writeEntries(out, entries.next());
+        }
+
+        template <typename T, typename U>
+        constexpr void writeEntries(JSONOutput &out, const JSONDict<T, U> &dict) noexcept
+        {
+            writeEntries(out, dict.entries());
+        }
+
+        template <typename T, size_t I>
+        constexpr void writeField(JSONOutput &out, const T &value) noexcept
+        {
+            constexpr auto field {std::get<I>(JSONBinding<T>::fields)};
+            if (I != 0) {
+                out.put(',');
+            }
+            out.write(field.name, sizeof(field.name) - 1);
+            out.put(':');
+            writeValue(out, value.*(field.member));
+        }
+
+        template <typename T, size_t... I>
+        constexpr void writeFields(JSONOutput &out, const T &value, std::index_sequence<I...>) noexcept
+        {
+            (writeField<T, I>(out, value), ...);
+        }
+
+        template <typename T>
+        constexpr void writeValue(JSONOutput &out, const T &value) noexcept
+        {
+            if constexpr (std::is_same_v<T, bool>) {
+                value ? out.write("true", 4) : out.write("false", 5);
+            } else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>) {
+                char digits[maxNumberLength] {};
+                out.write(digits, formatUnsigned(static_cast<uint64_t>(value), digits));
+            } else if constexpr (std::is_integral_v<T>) {
+                char digits[maxNumberLength] {};
+                out.write(digits, formatInteger(static_cast<int64_t>(value), digits));
+            } else if constexpr (std::is_floating_point_v<T>) {
+                writeNumber(out, static_cast<double>(value));
+            } else if constexpr (std::is_same_v<T, StringView>) {
+                // string values are tokens of the parsed input, quotes and escapes included
+                out.write(value.data(), value.size());
+            } else if constexpr (std::is_same_v<T, JSONScalar>) {
+                if (value.template is<int64_t>()) {
+                    writeValue(out, value.template as<int64_t>().value());
+                } else if (value.template is<uint64_t>()) {
+                    writeValue(out, value.template as<uint64_t>().value());
+                } else if (value.template is<double>()) {
+                    writeNumber(out, value.template as<double>());
+                } else if (value.template is<bool>()) {
+                    writeValue(out, value.template as<bool>().value());
+                } else if (value.template is<StringView>()) {
+                    writeValue(out, value.template as<StringView>().value());
+                } else {
+                    out.write("null", 4);
+                }
+            } else if constexpr (isStdArray<T>) {
+                out.put('[');
+                for (size_t i = 0; i < value.size(); ++i) {
+                    if (i != 0) {
+                        out.put(',');
+                    }
+                    writeValue(out, value[i]);
+                }
+                out.put(']');
+            } else if constexpr (isJSONObject<T> || isJSONDict<T>) {
+                out.put('{');
+                writeEntries(out, value);
+                out.put('}');
+            } else {
+                static_assert(hasJSONBinding<T>, "type can not be serialized, it is neither a JSON value nor has a JSONBinding");
+                out.put('{');
+                writeFields(out, value, std::make_index_sequence<fieldCount<T>>());
+                out.put('}');
+            }
+        }
+    } // namespace priv
+
+    ///
+    /// Serializes an object tree (JSONObject, JSONDict), an array or a bound struct into buffer, without allocations.
+    /// No terminating '\0' is written, the buffer only holds the complete document if the returned length fits.
+    /// @return length of the whole document, larger than capacity if the buffer was too small
+    ///
+    template <typename T>
+    constexpr size_t serializeJSON(const T &value, char *buffer, size_t capacity) noexcept
+    {
+        priv::JSONOutput out {buffer, capacity};
+        priv::writeValue(out, value);
+        return out.size();
+    }
+
+    ///
+    /// @return constexpr object serialized into a '\0' terminated array of exactly the needed size
+    ///
+    template <const auto &object>
+    constexpr auto serializeJSON() noexcept
+    {
+        constexpr size_t length {serializeJSON(object, nullptr, 0)};
+        std::array<char, length + 1> result {};
+        serializeJSON(object, result.data(), length);
+        return result;
+    }
+
+    ///
+    /// Builds a document from runtime data into a caller supplied buffer, without allocations.
+    /// Keys and strings are escaped, values of other types are serialized like serializeJSON does.
+    ///
+    class JSONWriter
+    {
+    public:
+        JSONWriter(char *buffer, size_t capacity) noexcept
+            : out_ {buffer, capacity}
+            , capacity_ {capacity}
+        {
+        }
+
+        void startObject() noexcept
+        {
+            separate();
+            out_.put('{');
+            needsComma_ = false;
+        }
+        void endObject() noexcept
+        {
+            out_.put('}');
+            needsComma_ = true;
+        }
+        void startArray() noexcept
+        {
+            separate();
+            out_.put('[');
+            needsComma_ = false;
+        }
+        void endArray() noexcept
+        {
+            out_.put(']');
+            needsComma_ = true;
+        }
+
+        /// name of the next entry of an object, as unescaped UTF-8 text
+        void key(const char *str, size_t length) noexcept
+        {
+            separate();
+            out_.writeString(str, length);
+            out_.put(':');
+            needsComma_ = false;
+        }
+
+        /// string value, as unescaped UTF-8 text
+        void string(const char *str, size_t length) noexcept
+        {
+            separate();
+            out_.writeString(str, length);
+            needsComma_ = true;
+        }
+
+        void null() noexcept
+        {
+            separate();
+            out_.write("null", 4);
+            needsComma_ = true;
+        }
+
+        template <typename T>
+        void value(const T &value) noexcept
+        {
+            separate();
+            priv::writeValue(out_, value);
+            needsComma_ = true;
+        }
+
+        /// @return length of the document written so far, including the part which did not fit
+        size_t size() const noexcept
+        {
+            return out_.size();
+        }
+
+        /// @return true if the buffer was too small for the document
+        bool overflow() const noexcept
+        {
+            return out_.size() > capacity_;
+        }
+
+    private:
+        void separate() noexcept
+        {
+            if (needsComma_) {
+                out_.put(',');
+            }
+        }
+
+        priv::JSONOutput out_;
+        size_t capacity_;
+        bool needsComma_ {false};
+    };
+} // namespace ctjson
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "StringUtils.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ctjson
+{
+    namespace priv
+    {
+        /// FNV-1a hash of the key bytes
+        constexpr uint64_t hashKey(const char *str, size_t length) noexcept
+        {
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (size_t i = 0; i < length; ++i) {
+                hash ^= static_cast<uint8_t>(str[i]);
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        /// @return well mixed value derived from the key hash, independent for every seed
+        constexpr uint64_t mixHash(uint64_t hash, uint64_t seed) noexcept
+        {
+            hash ^= seed * 0x9e3779b97f4a7c15ull;
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ull;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        constexpr size_t tableSizeFor(size_t count) noexcept
+        {
+            size_t size = 1;
+            while (size < count) {
+                size <<= 1;
+            }
+            return size;
+        }
+    } // namespace priv
+
+    ///
+    /// Perfect hash of a fixed key set, built at compile time with hash and displace:
+    /// keys are grouped into buckets and every bucket gets a seed which moves all of its keys to free slots.
+    /// A lookup hashes the name once and compares it with a single key.
+    /// Duplicate keys resolve to their first position.
+    ///
+    template <size_t count>
+    class JSONKeyIndex
+    {
+        static constexpr size_t tableSize {priv::tableSizeFor(count)};
+        static constexpr size_t mask {tableSize - 1};
+        static constexpr uint64_t directSlot {uint64_t(1) << 63};
+        static constexpr uint64_t maxSeed {uint64_t(1) << 16};
+
+    public:
+        static constexpr size_t npos {static_cast<size_t>(-1)};
+
+        constexpr explicit JSONKeyIndex(const std::array<StringView, count> &keys) noexcept
+            : keys_ {keys}
+        {
+            std::array<uint64_t, count> hashes {};
+            std::array<size_t, tableSize + 1> bucketStart {};
+            std::array<size_t, tableSize> bucketSize {};
+            std::array<size_t, count> members {};
+
+            for (size_t i = 0; i < count; ++i) {
+                hashes[i] = priv::hashKey(keys[i].data(), keys[i].size());
+                ++bucketStart[bucketOf(hashes[i]) + 1];
+            }
+            for (size_t b = 0; b < tableSize; ++b) {
+                bucketStart[b + 1] += bucketStart[b];
+            }
+            size_t maxBucketSize = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const size_t b = bucketOf(hashes[i]);
+                bool duplicate = false;
+                for (size_t j = bucketStart[b]; j < bucketStart[b] + bucketSize[b]; ++j) {
+                    duplicate = duplicate || (hashes[members[j]] == hashes[i] && keys[members[j]].equals(keys[i]));
+                }
+                if (!duplicate) {
+                    members[bucketStart[b] + bucketSize[b]++] = i;
+                    maxBucketSize = (bucketSize[b] > maxBucketSize) ? bucketSize[b] : maxBucketSize;
+                }
+            }
+
+            for (size_t slot = 0; slot < tableSize; ++slot) {
+                slots_[slot] = npos;
+            }
+            // largest buckets first, while the table is still mostly empty
+            for (size_t size = maxBucketSize; size >= 2; --size) {
+                for (size_t b = 0; b < tableSize; ++b) {
+                    if (bucketSize[b] != size) {
+                        continue;
+                    }
+                    uint64_t seed = 1;
+                    while (seed <= maxSeed && !bucketFits(hashes, members, bucketStart[b], size, seed)) {
+                        ++seed;
+                    }
+                    if (seed > maxSeed) {
+                        valid_ = false;
+                        return;
+                    }
+                    for (size_t j = bucketStart[b]; j < bucketStart[b] + size; ++j) {
+                        slots_[slotOf(hashes[members[j]], seed)] = members[j];
+                    }
+                    seeds_[b] = seed;
+                }
+            }
+            // single keys need no search, they go straight to the remaining free slots
+            size_t freeSlot = 0;
+            for (size_t b = 0; b < tableSize; ++b) {
+                if (bucketSize[b] == 1) {
+                    while (slots_[freeSlot] != npos) {
+                        ++freeSlot;
+                    }
+                    slots_[freeSlot] = members[bucketStart[b]];
+                    seeds_[b] = directSlot | freeSlot;
+                }
+            }
+        }
+
+        /// @return false if no perfect hash was found, the caller has to fall back to a linear search
+        constexpr bool valid() const noexcept
+        {
+            return valid_;
+        }
+
+        /// @return position of the name in the key set, npos if not present
+        template <size_t N>
+        constexpr size_t find(const char (&name)[N]) const noexcept
+        {
+            return find(StringView(name, N - 1));
+        }
+
+        constexpr size_t find(const StringView &name) const noexcept
+        {
+            const uint64_t hash {priv::hashKey(name.data(), name.size())};
+            const uint64_t seed {seeds_[bucketOf(hash)]};
+            if (seed == 0) {
+                return npos;
+            }
+            const size_t index {slots_[(seed & directSlot) ? static_cast<size_t>(seed & ~directSlot) : slotOf(hash, seed)]};
+            return (index != npos && keys_[index].equals(name)) ? index : npos;
+        }
+
+    private:
+        static constexpr size_t bucketOf(uint64_t hash) noexcept
+        {
+            return static_cast<size_t>(priv::mixHash(hash, 0) & mask);
+        }
+
+        static constexpr size_t slotOf(uint64_t hash, uint64_t seed) noexcept
+        {
+            return static_cast<size_t>(priv::mixHash(hash, seed) & mask);
+        }
+
+        constexpr bool bucketFits(const std::array<uint64_t, count> &hashes, const std::array<size_t, count> &members,
+                                  size_t first, size_t size, uint64_t seed) const noexcept
+        {
+            for (size_t j = first; j < first + size; ++j) {
+                const size_t slot = slotOf(hashes[members[j]], seed);
+                if (slots_[slot] != npos) {
+                    return false;
+                }
+                for (size_t k = first; k < j; ++k) {
+                    if (slotOf(hashes[members[k]], seed) == slot) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        std::array<StringView, count> keys_;
+        std::array<uint64_t, tableSize> seeds_ {};
+        std::array<size_t, tableSize> slots_ {};
+        bool valid_ {true};
+    };
+} // namespace ctjson
@@ -0,0 +1,757 @@
+#pragma once
+
+#include "StringEscapes.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace ctjson
+{
+    namespace priv
+    {
+        constexpr bool isDigit(char c) noexcept
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        /// Fixed capacity unsigned integer used for exact decimal to binary conversion.
+        class BigInteger
+        {
+        public:
+            static constexpr size_t capacity {136};
+
+            constexpr BigInteger() noexcept = default;
+
+            constexpr explicit BigInteger(uint64_t value) noexcept
+            {
+                while (value != 0) {
+                    limbs_[size_++] = static_cast<uint32_t>(value);
+                    value >>= 32;
+                }
+            }
+            constexpr bool isZero() const noexcept
+            {
+                return size_ == 0;
+            }
+            constexpr void multiplyAdd(uint32_t factor, uint32_t addend = 0) noexcept
+            {
+                uint64_t carry = addend;
+                for (size_t i = 0; i < size_; ++i) {
+                    const uint64_t product = static_cast<uint64_t>(limbs_[i]) * factor + carry;
+                    limbs_[i] = static_cast<uint32_t>(product);
+                    carry = product >> 32;
+                }
+                if (carry != 0) {
+                    limbs_[size_++] = static_cast<uint32_t>(carry);
+                }
+            }
+            constexpr void multiplyPow10(size_t exponent) noexcept
+            {
+                for (; exponent >= 9; exponent -= 9) {
+                    multiplyAdd(1000000000u);
+                }
+                for (; exponent > 0; --exponent) {
+                    multiplyAdd(10u);
+                }
+            }
+            constexpr size_t bitLength() const noexcept
+            {
+                if (size_ == 0) {
+                    return 0;
+                }
+                size_t bits = 32 * (size_ - 1);
+                for (uint32_t top = limbs_[size_ - 1]; top != 0; top >>= 1) {
+                    ++bits;
+                }
+                return bits;
+            }
+            constexpr bool bit(size_t index) const noexcept
+            {
+                return index / 32 < size_ && ((limbs_[index / 32] >> (index % 32)) & 1u);
+            }
+            /// @return true if any of the lowest count bits is set
+            constexpr bool anyBelow(size_t count) const noexcept
+            {
+                for (size_t i = 0; i < size_ && 32 * i < count; ++i) {
+                    const size_t bits = count - 32 * i;
+                    const uint32_t mask = bits >= 32 ? 0xFFFFFFFFu : ((1u << bits) - 1);
+                    if (limbs_[i] & mask) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            constexpr void shiftLeft(size_t count) noexcept
+            {
+                if (size_ == 0 || count == 0) {
+                    return;
+                }
+                const size_t limbShift = count / 32;
+                const size_t bitShift = count % 32;
+                size_t newSize = size_ + limbShift + 1;
+                for (size_t i = newSize; i-- > 0;) {
+                    const uint64_t high = (i >= limbShift && i - limbShift < size_) ? limbs_[i - limbShift] : 0;
+                    const uint64_t low = (bitShift != 0 && i >= limbShift + 1 && i - limbShift - 1 < size_) ? limbs_[i - limbShift - 1] : 0;
+                    limbs_[i] = static_cast<uint32_t>((high << bitShift) | (low >> (32 - bitShift)));
+                }
+                size_ = newSize;
+                normalize();
+            }
+            constexpr void shiftRightOne() noexcept
+            {
+                for (size_t i = 0; i < size_; ++i) {
+                    const uint32_t next = (i + 1 < size_) ? limbs_[i + 1] : 0;
+                    limbs_[i] = (limbs_[i] >> 1) | (next << 31);
+                }
+                normalize();
+            }
+            constexpr int compare(const BigInteger &other) const noexcept
+            {
+                if (size_ != other.size_) {
+                    return size_ < other.size_ ? -1 : 1;
+                }
+                for (size_t i = size_; i-- > 0;) {
+                    if (limbs_[i] != other.limbs_[i]) {
+                        return limbs_[i] < other.limbs_[i] ? -1 : 1;
+                    }
+                }
+                return 0;
+            }
+            /// subtracts other, requires *this >= other
+            constexpr void subtract(const BigInteger &other) noexcept
+            {
+                int64_t borrow = 0;
+                for (size_t i = 0; i < size_; ++i) {
+                    int64_t diff = static_cast<int64_t>(limbs_[i]) - borrow - (i < other.size_ ? other.limbs_[i] : 0);
+                    borrow = diff < 0 ? 1 : 0;
+                    limbs_[i] = static_cast<uint32_t>(diff + (borrow << 32));
+                }
+                normalize();
+            }
+            /// @return count bits starting at index from, count <= 64
+            constexpr uint64_t bits(size_t from, size_t count) const noexcept
+            {
+                uint64_t result = 0;
+                for (size_t i = count; i-- > 0;) {
+                    result = (result << 1) | (bit(from + i) ? 1u : 0u);
+                }
+                return result;
+            }
+
+        private:
+            constexpr void normalize() noexcept
+            {
+                while (size_ > 0 && limbs_[size_ - 1] == 0) {
+                    --size_;
+                }
+            }
+
+            uint32_t limbs_[capacity] {};
+            size_t size_ {0};
+        };
+
+        /// @return 2^exponent, exact for every exponent in the normal double range
+        constexpr double pow2(int exponent) noexcept
+        {
+            double result = 1.0;
+            const double factor = exponent < 0 ? 0.5 : 2.0;
+            for (int i = 0; i < (exponent < 0 ? -exponent : exponent); ++i) {
+                result *= factor;
+            }
+            return result;
+        }
+
+        /// @return 10^exponent, exact for exponent <= 22
+        constexpr double pow10(int exponent) noexcept
+        {
+            double result = 1.0;
+            for (int i = 0; i < exponent; ++i) {
+                result *= 10.0;
+            }
+            return result;
+        }
+
+        /// Decomposition of a JSON number literal.
+        struct NumberParts
+        {
+            bool negative {false};
+            size_t intBegin {0};
+            size_t intEnd {0};
+            size_t fracBegin {0};
+            size_t fracEnd {0};
+            int64_t exponent {0};
+
+            constexpr size_t digitCount() const noexcept
+            {
+                return (intEnd - intBegin) + (fracEnd - fracBegin);
+            }
+            /// @return idx-th digit of the integer and fraction parts concatenated
+            constexpr char digit(const char *str, size_t idx) const noexcept
+            {
+                return idx < intEnd - intBegin ? str[intBegin + idx] : str[fracBegin + idx - (intEnd - intBegin)];
+            }
+        };
+
+        constexpr NumberParts splitNumber(const char *str, size_t length) noexcept
+        {
+            NumberParts parts;
+            size_t pos = 0;
+            if (pos < length && str[pos] == '-') {
+                parts.negative = true;
+                ++pos;
+            }
+            parts.intBegin = pos;
+            while (pos < length && isDigit(str[pos])) {
+                ++pos;
+            }
+            parts.intEnd = pos;
+            parts.fracBegin = parts.fracEnd = pos;
+            if (pos < length && str[pos] == '.') {
+                parts.fracBegin = ++pos;
+                while (pos < length && isDigit(str[pos])) {
+                    ++pos;
+                }
+                parts.fracEnd = pos;
+            }
+            if (pos < length && (str[pos] == 'e' || str[pos] == 'E')) {
+                ++pos;
+                bool negativeExponent = false;
+                if (pos < length && (str[pos] == '+' || str[pos] == '-')) {
+                    negativeExponent = (str[pos] == '-');
+                    ++pos;
+                }
+                int64_t exponent = 0;
+                for (; pos < length && isDigit(str[pos]); ++pos) {
+                    // anything above this limit is out of range anyway
+                    if (exponent < 100000) {
+                        exponent = exponent * 10 + (str[pos] - '0');
+                    }
+                }
+                parts.exponent = negativeExponent ? -exponent : exponent;
+            }
+            return parts;
+        }
+
+        /// @return m * 2^exponent where m is an exactly representable mantissa
+        constexpr double scale(uint64_t mantissa, int exponent) noexcept
+        {
+            const int half = exponent / 2;
+            return static_cast<double>(mantissa) * pow2(half) * pow2(exponent - half);
+        }
+
+        /// @return value * 2^exponent rounded to nearest-even, value has bit 63 set
+        constexpr double roundToDouble(uint64_t value, bool sticky, int exponent) noexcept
+        {
+            const int binaryExponent = exponent + 63;
+            if (binaryExponent > 1023) {
+                return std::numeric_limits<double>::infinity();
+            }
+            const int keep = binaryExponent >= -1022 ? 53 : 53 - (-1022 - binaryExponent);
+            if (keep < 0) {
+                return 0.0;
+            }
+            const int drop = 64 - keep;
+            uint64_t mantissa = drop < 64 ? (value >> drop) : 0;
+            const bool half = (value >> (drop - 1)) & 1u;
+            const bool rest = sticky || (drop > 1 && (value & ((uint64_t {1} << (drop - 1)) - 1)) != 0);
+            if (half && (rest || (mantissa & 1u))) {
+                ++mantissa;
+                if (keep == 53 && mantissa == (uint64_t {1} << 53) && binaryExponent == 1023) {
+                    return std::numeric_limits<double>::infinity();
+                }
+            }
+            return scale(mantissa, exponent + drop);
+        }
+
+        /// splits a finite positive value into mantissa * 2^exponent with mantissa < 2^53
+        constexpr void decomposeDouble(double value, uint64_t &mantissa, int &exponent) noexcept
+        {
+            constexpr double two53 = 9007199254740992.0;
+            exponent = 0;
+            // scaling by powers of two is exact as long as the value stays normal
+            for (; value >= two53 * 4294967296.0; value /= 4294967296.0) {
+                exponent += 32;
+            }
+            for (; value >= two53; value /= 2.0) {
+                ++exponent;
+            }
+            for (; value < two53 / 4294967296.0; value *= 4294967296.0) {
+                exponent -= 32;
+            }
+            for (; value < two53 / 2.0; value *= 2.0) {
+                --exponent;
+            }
+            mantissa = static_cast<uint64_t>(value);
+        }
+
+        /// Decimal digits of a double, value = d[0].d[1]d[2]... * 10^exponent
+        struct DecimalDigits
+        {
+            static constexpr size_t count {24};
+
+            char digits[count] {};
+            int exponent {0};
+            /// true if non-zero digits follow the generated ones
+            bool sticky {false};
+        };
+
+        /// @return the first DecimalDigits::count exact decimal digits of a finite positive value
+        constexpr DecimalDigits exactDigits(double value) noexcept
+        {
+            uint64_t mantissa {0};
+            int exponent2 {0};
+            decomposeDouble(value, mantissa, exponent2);
+            BigInteger numerator {mantissa};
+            BigInteger denominator {1};
+            if (exponent2 >= 0) {
+                numerator.shiftLeft(static_cast<size_t>(exponent2));
+            } else {
+                denominator.shiftLeft(static_cast<size_t>(-exponent2));
+            }
+            // log10(2) estimate of the decimal exponent, corrected below
+            const int bits {static_cast<int>(BigInteger(mantissa).bitLength()) + exponent2 - 1};
+            int exponent10 {bits * 30103 / 100000 - (bits < 0 ? 1 : 0)};
+            if (exponent10 >= 0) {
+                denominator.multiplyPow10(static_cast<size_t>(exponent10));
+            } else {
+                numerator.multiplyPow10(static_cast<size_t>(-exponent10));
+            }
+            while (true) {
+                BigInteger upper {denominator};
+                upper.multiplyAdd(10);
+                if (numerator.compare(upper) < 0) {
+                    break;
+                }
+                denominator = upper;
+                ++exponent10;
+            }
+            while (numerator.compare(denominator) < 0) {
+                numerator.multiplyAdd(10);
+                --exponent10;
+            }
+            DecimalDigits result;
+            result.exponent = exponent10;
+            for (size_t i = 0; i < DecimalDigits::count; ++i) {
+                char digit {0};
+                while (numerator.compare(denominator) >= 0) {
+                    numerator.subtract(denominator);
+                    ++digit;
+                }
+                result.digits[i] = digit;
+                numerator.multiplyAdd(10);
+            }
+            result.sticky = !numerator.isZero();
+            return result;
+        }
+
+        /// @return length of digits[0..count) rounded to count digits (half to even), written as d.ddde+x to out;
+        /// exponent is updated if the rounding carries into a new digit
+        constexpr size_t roundDigits(const DecimalDigits &exact, size_t count, char *digits, int &exponent) noexcept
+        {
+            bool tail {exact.sticky};
+            for (size_t i = count + 1; i < DecimalDigits::count; ++i) {
+                tail = tail || exact.digits[i] != 0;
+            }
+            const char next {exact.digits[count]};
+            const bool roundUp {next > 5 || (next == 5 && (tail || (exact.digits[count - 1] & 1) != 0))};
+            exponent = exact.exponent;
+            for (size_t i = 0; i < count; ++i) {
+                digits[i] = exact.digits[i];
+            }
+            if (roundUp) {
+                size_t i {count};
+                while (i > 0 && digits[i - 1] == 9) {
+                    digits[--i] = 0;
+                }
+                if (i == 0) {
+                    digits[0] = 1;
+                    ++exponent;
+                    return 1;
+                }
+                ++digits[i - 1];
+            }
+            while (count > 1 && digits[count - 1] == 0) {
+                --count;
+            }
+            return count;
+        }
+
+        /// writes the decimal exponent of scientific notation, with at least two digits like printf
+        constexpr size_t formatExponent(int exponent, char *out) noexcept
+        {
+            size_t length {0};
+            out[length++] = 'e';
+            out[length++] = exponent < 0 ? '-' : '+';
+            const int magnitude {exponent < 0 ? -exponent : exponent};
+            if (magnitude >= 100) {
+                out[length++] = static_cast<char>('0' + magnitude / 100);
+            }
+            out[length++] = static_cast<char>('0' + magnitude / 10 % 10);
+            out[length++] = static_cast<char>('0' + magnitude % 10);
+            return length;
+        }
+
+        /// writes digits * 10^exponent (first digit at 10^exponent) in fixed or scientific notation, whichever is shorter;
+        /// a fixed integer is padded with zeros, or written with the digits of exact unless it is null
+        constexpr size_t formatDigits(const char *digits, size_t count, int exponent, const char *exact, char *out) noexcept
+        {
+            const size_t exponentLength {static_cast<size_t>((exponent <= -100 || exponent >= 100) ? 5 : 4)};
+            const size_t scientificLength {count + (count > 1 ? 1 : 0) + exponentLength};
+            const size_t fixedLength {exponent < 0 ? count + 1 + static_cast<size_t>(-exponent)
+                                                   : (count <= static_cast<size_t>(exponent) + 1 ? static_cast<size_t>(exponent) + 1 : count + 1)};
+            size_t length {0};
+            if (fixedLength <= scientificLength) {
+                if (exponent < 0) {
+                    out[length++] = '0';
+                    out[length++] = '.';
+                    for (int i = -1; i > exponent; --i) {
+                        out[length++] = '0';
+                    }
+                }
+                for (size_t i = 0; i < count || (exponent >= 0 && i <= static_cast<size_t>(exponent)); ++i) {
+                    if (exponent >= 0 && i == static_cast<size_t>(exponent) + 1) {
+                        out[length++] = '.';
+                    }
+                    out[length++] = static_cast<char>('0' + (exact ? exact[i] : i < count ? digits[i] : 0));
+                }
+                return length;
+            }
+            out[length++] = static_cast<char>('0' + digits[0]);
+            if (count > 1) {
+                out[length++] = '.';
+                for (size_t i = 1; i < count; ++i) {
+                    out[length++] = static_cast<char>('0' + digits[i]);
+                }
+            }
+            return length + formatExponent(exponent, out + length);
+        }
+    } // namespace priv
+
+    /// @return length of the JSON number (sign, fraction, exponent) at the start of str, 0 if there is none
+    constexpr size_t scanNumber(const char *str, size_t length) noexcept
+    {
+        size_t pos = 0;
+        if (pos < length && str[pos] == '-') {
+            ++pos;
+        }
+        if (pos >= length || !priv::isDigit(str[pos])) {
+            return 0;
+        }
+        if (str[pos] == '0') {
+            ++pos;
+        } else {
+            while (pos < length && priv::isDigit(str[pos])) {
+                ++pos;
+            }
+        }
+        if (pos < length && str[pos] == '.') {
+            if (pos + 1 >= length || !priv::isDigit(str[pos + 1])) {
+                return 0;
+            }
+            pos += 2;
+            while (pos < length && priv::isDigit(str[pos])) {
+                ++pos;
+            }
+        }
+        if (pos < length && (str[pos] == 'e' || str[pos] == 'E')) {
+            ++pos;
+            if (pos < length && (str[pos] == '+' || str[pos] == '-')) {
+                ++pos;
+            }
+            if (pos >= length || !priv::isDigit(str[pos])) {
+                return 0;
+            }
+            while (pos < length && priv::isDigit(str[pos])) {
+                ++pos;
+            }
+        }
+        return pos;
+    }
+
+    /// @return true if the number literal has neither a fraction nor an exponent
+    constexpr bool isIntegerNumber(const char *str, size_t length) noexcept
+    {
+        for (size_t i = 0; i < length; ++i) {
+            if (str[i] == '.' || str[i] == 'e' || str[i] == 'E') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    namespace priv
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        constexpr bool swarDigits {true};
+#else
+        constexpr bool swarDigits {false};
+#endif
+
+        /// @return the eight bytes at str as a little endian word
+        inline uint64_t loadDigits(const char *str) noexcept
+        {
+            uint64_t word;
+            std::memcpy(&word, str, sizeof(word));
+            return word;
+        }
+
+        /// @return true if every byte of the word is a decimal digit
+        inline bool isEightDigits(uint64_t word) noexcept
+        {
+            return ((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+        }
+
+        /// @return value of eight decimal digits, the first one being the lowest byte; pairs, then quads are combined in parallel
+        inline uint32_t parseEightDigits(uint64_t word) noexcept
+        {
+            word = ((word & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+            word = ((word & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+            return static_cast<uint32_t>(((word & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+        }
+
+        /// reads the digit sequence starting at pos into value, pos ends past it
+        /// @return false if the value does not fit 64 bits, the digits are consumed anyway
+        constexpr bool parseDigits(const char *str, size_t length, size_t &pos, uint64_t &value) noexcept
+        {
+            bool fits {true};
+            value = 0;
+            if (swarDigits && !isConstantEvaluated()) {
+                // sixteen digits can not overflow, the rest is checked one by one
+                const size_t begin {pos};
+                while (pos - begin < 16 && length - pos >= 8 && isEightDigits(loadDigits(str + pos))) {
+                    value = value * 100000000 + parseEightDigits(loadDigits(str + pos));
+                    pos += 8;
+                }
+            }
+            for (; pos < length && isDigit(str[pos]); ++pos) {
+                const uint64_t digit {static_cast<uint64_t>(str[pos] - '0')};
+                fits = fits && value <= (std::numeric_limits<uint64_t>::max() - digit) / 10;
+                value = value * 10 + digit;
+            }
+            return fits;
+        }
+    } // namespace priv
+
+    /// @return integer value of the optionally signed digit sequence at the start of str, values which do not fit wrap around
+    constexpr int64_t parseInt64(const char *str, size_t length) noexcept
+    {
+        size_t pos = 0;
+        const bool negative = (length > 0 && str[0] == '-');
+        if (negative) {
+            ++pos;
+        }
+        uint64_t result = 0;
+        priv::parseDigits(str, length, pos, result);
+        return negative ? static_cast<int64_t>(0 - result) : static_cast<int64_t>(result);
+    }
+
+    /// @return integer value of the unsigned digit sequence at the start of str, values which do not fit wrap around
+    constexpr uint64_t parseUInt64(const char *str, size_t length) noexcept
+    {
+        size_t pos = 0;
+        uint64_t result = 0;
+        priv::parseDigits(str, length, pos, result);
+        return result;
+    }
+
+    /// Narrowest of the integer types an integer literal is materialized as
+    enum class IntegerRange : uint8_t {
+        Int32,
+        Int64,
+        UInt64,
+        /// fits none of them
+        Overflow
+    };
+
+    /// @return range of an integer number literal (see isIntegerNumber)
+    constexpr IntegerRange integerRange(const char *str, size_t length) noexcept
+    {
+        size_t pos = 0;
+        const bool negative = (length > 0 && str[0] == '-');
+        if (negative) {
+            ++pos;
+        }
+        uint64_t magnitude = 0;
+        if (!priv::parseDigits(str, length, pos, magnitude)) {
+            return IntegerRange::Overflow;
+        }
+        const uint64_t int32Limit {static_cast<uint64_t>(std::numeric_limits<int32_t>::max()) + (negative ? 1 : 0)};
+        const uint64_t int64Limit {static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0)};
+        if (magnitude <= int32Limit) {
+            return IntegerRange::Int32;
+        }
+        if (magnitude <= int64Limit) {
+            return IntegerRange::Int64;
+        }
+        return negative ? IntegerRange::Overflow : IntegerRange::UInt64;
+    }
+
+    /// @return JSON number literal converted to the nearest double (round half to even)
+    constexpr double parseDouble(const char *str, size_t length) noexcept
+    {
+        // significant digits beyond this count can only affect the rounding through a sticky digit
+        constexpr size_t maxDigits {780};
+
+        const priv::NumberParts parts {priv::splitNumber(str, length)};
+        const double sign = parts.negative ? -1.0 : 1.0;
+        const size_t totalDigits = parts.digitCount();
+
+        size_t first = 0;
+        while (first < totalDigits && parts.digit(str, first) == '0') {
+            ++first;
+        }
+        size_t last = totalDigits;
+        while (last > first && parts.digit(str, last - 1) == '0') {
+            --last;
+        }
+        if (first == last) {
+            return sign * 0.0;
+        }
+        const size_t digits = last - first;
+        int64_t exponent10 = parts.exponent - static_cast<int64_t>(parts.fracEnd - parts.fracBegin)
+            + static_cast<int64_t>(totalDigits - last);
+
+        // exact fast path: both operands are exactly representable, one rounding step
+        if (digits <= 15 && exponent10 >= -22 && exponent10 <= 22) {
+            uint64_t mantissa = 0;
+            for (size_t i = first; i < last; ++i) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(parts.digit(str, i) - '0');
+            }
+            return sign * (exponent10 < 0 ? static_cast<double>(mantissa) / priv::pow10(static_cast<int>(-exponent10))
+                                          : static_cast<double>(mantissa) * priv::pow10(static_cast<int>(exponent10)));
+        }
+        if (static_cast<int64_t>(digits) + exponent10 > 310) {
+            return sign * std::numeric_limits<double>::infinity();
+        }
+        if (static_cast<int64_t>(digits) + exponent10 < -343) {
+            return sign * 0.0;
+        }
+
+        priv::BigInteger value;
+        const size_t used = digits < maxDigits ? digits : maxDigits;
+        for (size_t i = first; i < first + used; ++i) {
+            value.multiplyAdd(10, static_cast<uint32_t>(parts.digit(str, i) - '0'));
+        }
+        exponent10 += static_cast<int64_t>(digits - used);
+        if (used < digits) {
+            // the dropped tail is non-zero (trailing zeros were stripped)
+            value.multiplyAdd(10, 1);
+            --exponent10;
+        }
+
+        uint64_t top = 0;
+        bool sticky = false;
+        int exponent2 = 0;
+        if (exponent10 >= 0) {
+            value.multiplyPow10(static_cast<size_t>(exponent10));
+            const size_t bits = value.bitLength();
+            if (bits <= 64) {
+                top = value.bits(0, bits) << (64 - bits);
+                exponent2 = static_cast<int>(bits) - 64;
+            } else {
+                top = value.bits(bits - 64, 64);
+                sticky = value.anyBelow(bits - 64);
+                exponent2 = static_cast<int>(bits) - 64;
+            }
+        } else {
+            priv::BigInteger divisor {1};
+            divisor.multiplyPow10(static_cast<size_t>(-exponent10));
+            // scale so that the quotient lies in (2^62, 2^64)
+            const int shift = static_cast<int>(divisor.bitLength()) - static_cast<int>(value.bitLength()) + 63;
+            if (shift >= 0) {
+                value.shiftLeft(static_cast<size_t>(shift));
+            } else {
+                divisor.shiftLeft(static_cast<size_t>(-shift));
+            }
+            divisor.shiftLeft(63);
+            for (int bit = 63; bit >= 0; --bit) {
+                if (value.compare(divisor) >= 0) {
+                    value.subtract(divisor);
+                    top |= uint64_t {1} << bit;
+                }
+                divisor.shiftRightOne();
+            }
+            sticky = !value.isZero();
+            exponent2 = -shift;
+        }
+        while ((top >> 63) == 0) {
+            top <<= 1;
+            --exponent2;
+        }
+        return sign * priv::roundToDouble(top, sticky, exponent2);
+    }
+
+    /// maximum length of formatInteger and formatDouble output
+    constexpr size_t maxNumberLength {32};
+
+    /// @return number of characters of value written to out
+    constexpr size_t formatUnsigned(uint64_t value, char *out) noexcept
+    {
+        char digits[20] {};
+        size_t count {0};
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        size_t length {0};
+        while (count > 0) {
+            out[length++] = digits[--count];
+        }
+        return length;
+    }
+
+    /// @return number of characters of value written to out
+    constexpr size_t formatInteger(int64_t value, char *out) noexcept
+    {
+        if (value < 0) {
+            out[0] = '-';
+            return 1 + formatUnsigned(0 - static_cast<uint64_t>(value), out + 1);
+        }
+        return formatUnsigned(static_cast<uint64_t>(value), out);
+    }
+
+    ///
+    /// Writes the shortest decimal which parses back to value, in the notation of std::to_chars:
+    /// fixed or scientific, whichever is shorter. Uses exact arithmetic, also at compile time.
+    /// @return number of characters written to out, 0 for infinity and NaN which JSON can not represent
+    ///
+    constexpr size_t formatDouble(double value, char *out) noexcept
+    {
+        if (value != value || value == std::numeric_limits<double>::infinity() || value == -std::numeric_limits<double>::infinity()) {
+            return 0;
+        }
+        size_t length {0};
+        if (value < 0) {
+            out[length++] = '-';
+            value = -value;
+        }
+        if (value == 0) {
+            out[length++] = '0';
+            return length;
+        }
+        const priv::DecimalDigits exact {priv::exactDigits(value)};
+        char digits[priv::DecimalDigits::count] {};
+        char candidate[maxNumberLength] {};
+        // 17 correctly rounded digits always parse back to the same value
+        for (size_t precision = 1; precision <= 17; ++precision) {
+            int exponent {0};
+            const size_t count {priv::roundDigits(exact, precision, digits, exponent)};
+            size_t candidateLength {0};
+            candidate[candidateLength++] = static_cast<char>('0' + digits[0]);
+            candidate[candidateLength++] = '.';
+            for (size_t i = 1; i < count; ++i) {
+                candidate[candidateLength++] = static_cast<char>('0' + digits[i]);
+            }
+            candidate[candidateLength++] = '0';
+            candidateLength += priv::formatExponent(exponent, candidate + candidateLength);
+            if (precision == 17 || parseDouble(candidate, candidateLength) == value) {
+                // large integers keep all their digits, like printf("%f")
+                const bool padded {exponent >= static_cast<int>(count) && exponent == exact.exponent && exponent < static_cast<int>(priv::DecimalDigits::count)};
+                const char *integerDigits {padded ? exact.digits : nullptr};
+                return length + priv::formatDigits(digits, count, exponent, integerDigits, out + length);
+            }
+        }
+        return length;
+    }
+} // namespace ctjson
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+///
+/// Validation and decoding of JSON strings (escape sequences and UTF-8)
+///
+namespace ctjson
+{
+    namespace priv
+    {
+        /// true during constant evaluation, compilers without the builtin always take the portable path
+        constexpr bool isConstantEvaluated() noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_is_constant_evaluated();
+#else
+            return true;
+#endif
+        }
+
+        /// @return position of the first byte at or after pos which is a quote, a backslash, a control character or not ASCII,
+        /// whole blocks of plain characters are skipped with SIMD; may stop early, the caller continues byte by byte
+        inline size_t skipPlainBlocks(const char *str, size_t length, size_t pos) noexcept
+        {
+#if defined(__AVX2__)
+            const __m256i space {_mm256_set1_epi8(' ')};
+            const __m256i quote {_mm256_set1_epi8('"')};
+            const __m256i backslash {_mm256_set1_epi8('\\')};
+            for (; pos + 32 <= length; pos += 32) {
+                const __m256i chunk {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + pos))};
+                // signed comparison against ' ': control characters and the bytes of multibyte characters (negative) are below it
+                const __m256i special {_mm256_or_si256(_mm256_cmpgt_epi8(space, chunk), _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)))};
+                const uint32_t mask {static_cast<uint32_t>(_mm256_movemask_epi8(special))};
+                if (mask != 0) {
+                    return pos + static_cast<size_t>(__builtin_ctz(mask));
+                }
+            }
+#elif defined(__SSE2__)
+            const __m128i space {_mm_set1_epi8(' ')};
+            const __m128i quote {_mm_set1_epi8('"')};
+            const __m128i backslash {_mm_set1_epi8('\\')};
+            for (; pos + 16 <= length; pos += 16) {
+                const __m128i chunk {_mm_loadu_si128(reinterpret_cast<const __m128i *>(str + pos))};
+                // signed comparison against ' ': control characters and the bytes of multibyte characters (negative) are below it
+                const __m128i special {_mm_or_si128(_mm_cmpgt_epi8(space, chunk), _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)))};
+                const uint32_t mask {static_cast<uint32_t>(_mm_movemask_epi8(special))};
+                if (mask != 0) {
+                    return pos + static_cast<size_t>(__builtin_ctz(mask));
+                }
+            }
+#endif
+            return pos;
+        }
+
+        constexpr size_t skipPlain(const char *str, size_t length, size_t pos) noexcept
+        {
+            return isConstantEvaluated() ? pos : skipPlainBlocks(str, length, pos);
+        }
+
+        /// @return position of the first byte at or after pos which has to be escaped (quote, backslash or control character),
+        /// whole blocks are skipped with SIMD; may stop early, the caller continues byte by byte
+        inline size_t skipVerbatimBlocks(const char *str, size_t length, size_t pos) noexcept
+        {
+#if defined(__AVX2__)
+            const __m256i space {_mm256_set1_epi8(0x1F)};
+            const __m256i quote {_mm256_set1_epi8('"')};
+            const __m256i backslash {_mm256_set1_epi8('\\')};
+            for (; pos + 32 <= length; pos += 32) {
+                const __m256i chunk {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + pos))};
+                // unsigned comparison, bytes of multibyte characters are copied as they are
+                const __m256i control {_mm256_cmpeq_epi8(_mm256_min_epu8(chunk, space), chunk)};
+                const __m256i special {_mm256_or_si256(control, _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)))};
+                const uint32_t mask {static_cast<uint32_t>(_mm256_movemask_epi8(special))};
+                if (mask != 0) {
+                    return pos + static_cast<size_t>(__builtin_ctz(mask));
+                }
+            }
+#elif defined(__SSE2__)
+            const __m128i space {_mm_set1_epi8(0x1F)};
+            const __m128i quote {_mm_set1_epi8('"')};
+            const __m128i backslash {_mm_set1_epi8('\\')};
+            for (; pos + 16 <= length; pos += 16) {
+                const __m128i chunk {_mm_loadu_si128(reinterpret_cast<const __m128i *>(str + pos))};
+                // unsigned comparison, bytes of multibyte characters are copied as they are
+                const __m128i control {_mm_cmpeq_epi8(_mm_min_epu8(chunk, space), chunk)};
+                const __m128i special {_mm_or_si128(control, _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)))};
+                const uint32_t mask {static_cast<uint32_t>(_mm_movemask_epi8(special))};
+                if (mask != 0) {
+                    return pos + static_cast<size_t>(__builtin_ctz(mask));
+                }
+            }
+#endif
+            return pos;
+        }
+
+        constexpr bool needsEscape(char c) noexcept
+        {
+            return c == '"' || c == '\\' || static_cast<uint8_t>(c) < 0x20;
+        }
+
+        /// @return value of four hex digits, -1 if one of them is not a hex digit
+        constexpr int32_t parseHex4(const char *str) noexcept
+        {
+            int32_t value {0};
+            for (size_t i = 0; i < 4; ++i) {
+                const char c {str[i]};
+                const int32_t digit {(c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1};
+                if (digit < 0) {
+                    return -1;
+                }
+                value = value * 16 + digit;
+            }
+            return value;
+        }
+
+        /// @return length of the well formed UTF-8 sequence at the start of str (RFC 3629), 0 if it is malformed
+        constexpr size_t utf8SequenceLength(const char *str, size_t length) noexcept
+        {
+            const uint8_t lead {static_cast<uint8_t>(str[0])};
+            size_t count {0};
+            uint8_t low {0x80};
+            uint8_t high {0xBF};
+            if (lead < 0x80) {
+                return 1;
+            } else if (lead >= 0xC2 && lead <= 0xDF) {
+                count = 2;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                count = 3;
+                // no overlong forms and no surrogates
+                low = (lead == 0xE0) ? 0xA0 : 0x80;
+                high = (lead == 0xED) ? 0x9F : 0xBF;
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                count = 4;
+                // no overlong forms and nothing above U+10FFFF
+                low = (lead == 0xF0) ? 0x90 : 0x80;
+                high = (lead == 0xF4) ? 0x8F : 0xBF;
+            } else {
+                return 0;
+            }
+            if (count > length) {
+                return 0;
+            }
+            const uint8_t second {static_cast<uint8_t>(str[1])};
+            if (second < low || second > high) {
+                return 0;
+            }
+            for (size_t i = 2; i < count; ++i) {
+                const uint8_t next {static_cast<uint8_t>(str[i])};
+                if (next < 0x80 || next > 0xBF) {
+                    return 0;
+                }
+            }
+            return count;
+        }
+
+        /// @return code point of the \u escape at str (including a following low surrogate), -1 if it is malformed;
+        /// consumed is set to the number of escape characters
+        constexpr int32_t parseUnicodeEscape(const char *str, size_t length, size_t &consumed) noexcept
+        {
+            if (length < 6) {
+                return -1;
+            }
+            const int32_t unit {parseHex4(str + 2)};
+            consumed = 6;
+            if (unit < 0xD800 || unit > 0xDFFF) {
+                return unit;
+            }
+            // a high surrogate has to be followed by a low one, code points are never half encoded
+            if (unit > 0xDBFF || length < 12 || str[6] != '\\' || str[7] != 'u') {
+                return -1;
+            }
+            const int32_t low {parseHex4(str + 8)};
+            if (low < 0xDC00 || low > 0xDFFF) {
+                return -1;
+            }
+            consumed = 12;
+            return 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+        }
+
+        /// @return number of bytes of the code point in UTF-8, written to out unless it is null
+        constexpr size_t encodeUTF8(int32_t codePoint, char *out) noexcept
+        {
+            const uint32_t cp {static_cast<uint32_t>(codePoint)};
+            const size_t count {cp < 0x80 ? 1u : cp < 0x800 ? 2u : cp < 0x10000 ? 3u : 4u};
+            if (out) {
+                if (count == 1) {
+                    out[0] = static_cast<char>(cp);
+                } else {
+                    constexpr uint8_t leads[] = {0, 0, 0xC0, 0xE0, 0xF0};
+                    out[0] = static_cast<char>(leads[count] | (cp >> (6 * (count - 1))));
+                    for (size_t i = 1; i < count; ++i) {
+                        out[i] = static_cast<char>(0x80 | ((cp >> (6 * (count - 1 - i))) & 0x3F));
+                    }
+                }
+            }
+            return count;
+        }
+
+        /// @return letter of the short escape sequence of c, 0 if it has none
+        constexpr char escapeLetter(char c) noexcept
+        {
+            switch (c) {
+            case '"':
+            case '\\':
+                return c;
+            case '\b':
+                return 'b';
+            case '\f':
+                return 'f';
+            case '\n':
+                return 'n';
+            case '\r':
+                return 'r';
+            case '\t':
+                return 't';
+            default:
+                return 0;
+            }
+        }
+
+        constexpr char escapedCharacter(char c) noexcept
+        {
+            switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                return c;
+            case 'b':
+                return '\b';
+            case 'f':
+                return '\f';
+            case 'n':
+                return '\n';
+            case 'r':
+                return '\r';
+            case 't':
+                return '\t';
+            default:
+                return 0;
+            }
+        }
+    } // namespace priv
+
+    /// @return position of the quote which ends the string opened at pos, length if the string is not terminated
+    constexpr size_t findStringEnd(const char *str, size_t length, size_t pos) noexcept
+    {
+        size_t end {pos + 1};
+        while (true) {
+            end = priv::skipPlain(str, length, end);
+            if (end >= length) {
+                return length;
+            }
+            if (str[end] == '"') {
+                return end;
+            }
+            // the escaped character never ends the string
+            end += (str[end] == '\\') ? 2 : 1;
+        }
+    }
+
+    /// @return true if the characters between the quotes of a string are valid:
+    /// known escapes, complete surrogate pairs, no control characters and well formed UTF-8
+    constexpr bool isValidStringContent(const char *str, size_t length) noexcept
+    {
+        size_t pos {0};
+        while (true) {
+            pos = priv::skipPlain(str, length, pos);
+            if (pos >= length) {
+                return true;
+            }
+            const char c {str[pos]};
+            if (c == '\\') {
+                if (pos + 1 >= length) {
+                    return false;
+                }
+                if (str[pos + 1] == 'u') {
+                    size_t consumed {0};
+                    if (priv::parseUnicodeEscape(str + pos, length - pos, consumed) < 0) {
+                        return false;
+                    }
+                    pos += consumed;
+                } else if (priv::escapedCharacter(str[pos + 1]) != 0) {
+                    pos += 2;
+                } else {
+                    return false;
+                }
+            } else if (static_cast<uint8_t>(c) < 0x20) {
+                return false;
+            } else {
+                const size_t sequence {priv::utf8SequenceLength(str + pos, length - pos)};
+                if (sequence == 0) {
+                    return false;
+                }
+                pos += sequence;
+            }
+        }
+    }
+
+    /// @return length of the valid string token (including the quotes) at pos, 0 if it is malformed or not terminated
+    constexpr size_t scanString(const char *str, size_t length, size_t pos) noexcept
+    {
+        const size_t end {findStringEnd(str, length, pos)};
+        if (end >= length || !isValidStringContent(str + pos + 1, end - pos - 1)) {
+            return 0;
+        }
+        return end - pos + 1;
+    }
+
+    /// Decodes a valid string token (including the quotes) to UTF-8
+    /// @return number of decoded bytes, written to out unless it is null
+    constexpr size_t unescapeString(const char *str, size_t length, char *out) noexcept
+    {
+        size_t count {0};
+        for (size_t pos = 1; pos + 1 < length;) {
+            if (str[pos] != '\\') {
+                if (out) {
+                    out[count] = str[pos];
+                }
+                ++count;
+                ++pos;
+            } else if (str[pos + 1] == 'u') {
+                size_t consumed {0};
+                const int32_t codePoint {priv::parseUnicodeEscape(str + pos, length - 1 - pos, consumed)};
+                count += priv::encodeUTF8(codePoint, out ? out + count : nullptr);
+                pos += consumed;
+            } else {
+                if (out) {
+                    out[count] = priv::escapedCharacter(str[pos + 1]);
+                }
+                ++count;
+                pos += 2;
+            }
+        }
+        return count;
+    }
+
+    /// Encodes UTF-8 text as the content of a string token (without the quotes),
+    /// quotes, backslashes and control characters are escaped
+    /// @return number of encoded bytes, written to out unless it is null
+    constexpr size_t escapeString(const char *str, size_t length, char *out) noexcept
+    {
+        size_t count {0};
+        for (size_t pos = 0; pos < length;) {
+            size_t end {priv::isConstantEvaluated() ? pos : priv::skipVerbatimBlocks(str, length, pos)};
+            while (end < length && !priv::needsEscape(str[end])) {
+                ++end;
+            }
+            if (out) {
+                if (priv::isConstantEvaluated()) {
+                    for (size_t i = pos; i < end; ++i) {
+                        out[count + i - pos] = str[i];
+                    }
+                } else if (end != pos) {
+                    std::memcpy(out + count, str + pos, end - pos);
+                }
+            }
+            count += end - pos;
+            if (end == length) {
+                break;
+            }
+            const char letter {priv::escapeLetter(str[end])};
+            if (out) {
+                constexpr char hex[] = "0123456789abcdef";
+                const uint8_t c {static_cast<uint8_t>(str[end])};
+                const char sequence[6] {'\\', letter ? letter : 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                for (size_t i = 0; i < (letter ? 2u : 6u); ++i) {
+                    out[count + i] = sequence[i];
+                }
+            }
+            count += letter ? 2 : 6;
+            pos = end + 1;
+        }
+        return count;
+    }
+} // namespace ctjson
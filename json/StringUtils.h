@@ -1,10 +1,138 @@
 #pragma once
 
+#include "NumberUtils.h"
+#include "StringEscapes.h"
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 namespace ctjson
 {
+    namespace priv
+    {
+        /// @return position of the first c at or after from, npos if there is none
+        constexpr size_t findCharacter(const char *str, size_t length, char c, size_t from) noexcept
+        {
+            if (from >= length) {
+                return std::string::npos;
+            }
+            if (!isConstantEvaluated()) {
+                // vectorized by the C library
+                const void *found {std::memchr(str + from, c, length - from)};
+                return found ? static_cast<size_t>(static_cast<const char *>(found) - str) : std::string::npos;
+            }
+            for (size_t i = from; i < length; ++i) {
+                if (str[i] == c) {
+                    return i;
+                }
+            }
+            return std::string::npos;
+        }
+
+        /// maximal suffix of the needle for one of the two byte orders, start (possibly -1) is the position before it
+        constexpr void maximalSuffix(const char *needle, size_t length, bool reversed, ptrdiff_t &start, size_t &period) noexcept
+        {
+            ptrdiff_t candidate {-1};
+            size_t next {0};
+            size_t offset {1};
+            period = 1;
+            while (next + offset < length) {
+                const uint8_t a {static_cast<uint8_t>(needle[static_cast<size_t>(candidate + static_cast<ptrdiff_t>(offset))])};
+                const uint8_t b {static_cast<uint8_t>(needle[next + offset])};
+                if (a == b) {
+                    if (offset == period) {
+                        next += period;
+                        offset = 1;
+                    } else {
+                        ++offset;
+                    }
+                } else if ((a > b) != reversed) {
+                    next += offset;
+                    offset = 1;
+                    period = static_cast<size_t>(static_cast<ptrdiff_t>(next) - candidate);
+                } else {
+                    candidate = static_cast<ptrdiff_t>(next++);
+                    offset = 1;
+                    period = 1;
+                }
+            }
+            start = candidate;
+        }
+
+        ///
+        /// Two-way string matching (Crochemore-Perrin): linear time, constant space,
+        /// combined with a Horspool shift on the last byte of the window
+        /// @return position of the first occurrence of the needle at or after from, npos if there is none
+        ///
+        constexpr size_t findSubstring(const char *haystack, size_t length, const char *needle, size_t needleLength, size_t from) noexcept
+        {
+            if (needleLength <= 1) {
+                return needleLength == 1 ? findCharacter(haystack, length, needle[0], from) : (from <= length ? from : std::string::npos);
+            }
+            if (from > length || length - from < needleLength) {
+                return std::string::npos;
+            }
+            // critical factorization: the later of the two maximal suffixes
+            ptrdiff_t start {0};
+            size_t period {0};
+            maximalSuffix(needle, needleLength, false, start, period);
+            ptrdiff_t reversedStart {0};
+            size_t reversedPeriod {0};
+            maximalSuffix(needle, needleLength, true, reversedStart, reversedPeriod);
+            if (reversedStart > start) {
+                start = reversedStart;
+                period = reversedPeriod;
+            }
+            const size_t split {static_cast<size_t>(start + 1)};
+            bool periodic {period + split <= needleLength};
+            for (size_t i = 0; periodic && i < split; ++i) {
+                periodic = (needle[i] == needle[i + period]);
+            }
+            // length of the prefix known to match after a shift by the period
+            size_t memory0 {0};
+            if (periodic) {
+                memory0 = needleLength - period;
+            } else {
+                period = (split - 1 > needleLength - split ? split - 1 : needleLength - split) + 1;
+            }
+            size_t shift[256] {};
+            for (size_t i = 0; i < needleLength; ++i) {
+                shift[static_cast<uint8_t>(needle[i])] = i + 1;
+            }
+
+            size_t memory {0};
+            for (size_t pos = from; pos + needleLength <= length;) {
+                const size_t last {shift[static_cast<uint8_t>(haystack[pos + needleLength - 1])]};
+                if (last != needleLength) {
+                    const size_t skip {last == 0 ? needleLength : needleLength - last};
+                    pos += (last != 0 && skip < memory) ? memory : skip;
+                    memory = 0;
+                    continue;
+                }
+                size_t k {split > memory ? split : memory};
+                while (k < needleLength && needle[k] == haystack[pos + k]) {
+                    ++k;
+                }
+                if (k < needleLength) {
+                    pos += k - split + 1;
+                    memory = 0;
+                    continue;
+                }
+                k = split;
+                while (k > memory && needle[k - 1] == haystack[pos + k - 1]) {
+                    --k;
+                }
+                if (k <= memory) {
+                    return pos;
+                }
+                pos += period;
+                memory = memory0;
+            }
+            return std::string::npos;
+        }
+    } // namespace priv
+
     class StringView
     {
     public:
@@ -27,13 +155,47 @@ namespace ctjson
             }
             return true;
         }
+        constexpr bool equals(const StringView &other) const noexcept
+        {
+            if (size_ != other.size_) {
+                return false;
+            }
+            for (size_t i = 0; i < size_; ++i) {
+                if (other.ptr_[i] != ptr_[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        constexpr const char *data() const noexcept
+        {
+            return ptr_;
+        }
+        constexpr size_t size() const noexcept
+        {
+            return size_;
+        }
+        /// @return position of the first occurrence of other at or after from, std::string::npos if there is none
+        constexpr size_t find(const StringView &other, size_t from = 0) const noexcept
+        {
+            return priv::findSubstring(ptr_, size_, other.ptr_, other.size_, from);
+        }
+        template <size_t N>
+        constexpr size_t find(const char (&other)[N], size_t from = 0) const noexcept
+        {
+            return priv::findSubstring(ptr_, size_, other, N - 1, from);
+        }
+        constexpr size_t find(char c, size_t from = 0) const noexcept
+        {
+            return priv::findCharacter(ptr_, size_, c, from);
+        }
         std::string toString() const
         {
             return std::string(ptr_, size_);
         }
     private:
         const char * ptr_ {nullptr};
-        const size_t size_ {0};
+        size_t size_ {0};
     };
 
 	template <const char* string, size_t start, size_t length, bool is_empty = (length == 0)>
@@ -168,38 +330,37 @@ namespace ctjson
 		template <size_t N>
 		static constexpr size_t find(const char(&other)[N], size_t start_pos = 0) noexcept
 		{
-			if constexpr (N - 1 > length) {
-				return std::string::npos;
-			}
-			for (size_t i = start + start_pos; i < start + length; ++i) {
-				if (i + N - 1 > start + length) {
-					return std::string::npos;
-				}
-				if (string[i] == other[0]) {
-					bool match = true;
-					for (size_t j = 1; j < N - 1; ++j) {
-						if (string[i + j] != other[j]) {
-							match = false;
-							break;
-						}
-					}
-					if (match) {
-						return i - start;
-					}
-				}
-			}
-			return std::string::npos;
+			return priv::findSubstring(string + start, length, other, N - 1, start_pos);
 		}
 		static constexpr int32_t toInt() noexcept
 		{
-			int32_t result = 0;
-			for (size_t i = start; i < start + length; ++i) {
-				if (string[i] < '0' || string[i] > '9') {
-					break;
-				}
-				result = result * 10 + (string[i] - '0');
-			}
-			return result;
+			return static_cast<int32_t>(toInt64());
+		}
+
+		static constexpr int64_t toInt64() noexcept
+		{
+			return parseInt64(string + start, length);
+		}
+
+		static constexpr uint64_t toUInt64() noexcept
+		{
+			return parseUInt64(string + start, length);
+		}
+
+		/// @return narrowest integer type holding the integer literal
+		static constexpr IntegerRange integerRange() noexcept
+		{
+			return ctjson::integerRange(string + start, length);
+		}
+
+		static constexpr double toDouble() noexcept
+		{
+			return parseDouble(string + start, length);
+		}
+
+		static constexpr bool isInteger() noexcept
+		{
+			return isIntegerNumber(string + start, length);
 		}
 
 		static std::string toString() noexcept
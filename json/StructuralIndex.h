@@ -0,0 +1,357 @@
+#pragma once
+
+#include "Tokenizer.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+namespace ctjson
+{
+    namespace priv
+    {
+        /// One bit per byte of a 64 byte block
+        struct JSONBlockMasks
+        {
+            uint64_t quote;
+            uint64_t backslash;
+            uint64_t structural;
+            uint64_t whitespace;
+            /// control characters and bytes of multibyte characters
+            uint64_t unusual;
+        };
+
+#if defined(__AVX2__)
+        inline uint64_t blockMask(__m256i lo, __m256i hi) noexcept
+        {
+            return static_cast<uint32_t>(_mm256_movemask_epi8(lo)) | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32);
+        }
+
+        inline JSONBlockMasks classifyBlock(const char *block) noexcept
+        {
+            // lookup by the low nibble, a byte matches if it equals its table entry
+            const __m256i whitespaceTable {_mm256_setr_epi8(' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100,
+                                                            ' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100)};
+            // '[' and ']' differ from '{' and '}' only in bit 5, which is set before the comparison;
+            // a few control characters match as well, which only adds positions that the tokenizer rejects
+            const __m256i structuralTable {_mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0,
+                                                             0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0)};
+            const __m256i bit5 {_mm256_set1_epi8(0x20)};
+            const __m256i space {_mm256_set1_epi8(0x20)};
+            const __m256i quote {_mm256_set1_epi8('"')};
+            const __m256i backslash {_mm256_set1_epi8('\\')};
+            const __m256i lo {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block))};
+            const __m256i hi {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32))};
+            return {
+                blockMask(_mm256_cmpeq_epi8(lo, quote), _mm256_cmpeq_epi8(hi, quote)),
+                blockMask(_mm256_cmpeq_epi8(lo, backslash), _mm256_cmpeq_epi8(hi, backslash)),
+                blockMask(_mm256_cmpeq_epi8(_mm256_or_si256(lo, bit5), _mm256_shuffle_epi8(structuralTable, lo)),
+                          _mm256_cmpeq_epi8(_mm256_or_si256(hi, bit5), _mm256_shuffle_epi8(structuralTable, hi))),
+                blockMask(_mm256_cmpeq_epi8(lo, _mm256_shuffle_epi8(whitespaceTable, lo)),
+                          _mm256_cmpeq_epi8(hi, _mm256_shuffle_epi8(whitespaceTable, hi))),
+                // signed comparison, bytes of multibyte characters are negative
+                blockMask(_mm256_cmpgt_epi8(space, lo), _mm256_cmpgt_epi8(space, hi))
+            };
+        }
+#elif defined(__SSE2__)
+        inline uint64_t chunkMask(__m128i matches, size_t chunk) noexcept
+        {
+            return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(matches))) << (16 * chunk);
+        }
+
+        inline JSONBlockMasks classifyBlock(const char *block) noexcept
+        {
+            JSONBlockMasks masks {0, 0, 0, 0, 0};
+            for (size_t i = 0; i < 4; ++i) {
+                const __m128i chunk {_mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16 * i))};
+                // '[' and ']' differ from '{' and '}' only in bit 5
+                const __m128i folded {_mm_or_si128(chunk, _mm_set1_epi8(0x20))};
+                masks.quote |= chunkMask(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), i);
+                masks.backslash |= chunkMask(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')), i);
+                masks.structural |= chunkMask(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+                                                           _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')))), i);
+                masks.whitespace |= chunkMask(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                                                           _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')))), i);
+                // signed comparison, bytes of multibyte characters are negative
+                masks.unusual |= chunkMask(_mm_cmpgt_epi8(_mm_set1_epi8(0x20), chunk), i);
+            }
+            return masks;
+        }
+#else
+        inline JSONBlockMasks classifyBlock(const char *block) noexcept
+        {
+            JSONBlockMasks masks {0, 0, 0, 0, 0};
+            for (size_t i = 0; i < 64; ++i) {
+                const char c {block[i]};
+                const uint64_t bit {uint64_t(1) << i};
+                masks.quote |= (c == '"') ? bit : 0;
+                masks.backslash |= (c == '\\') ? bit : 0;
+                masks.structural |= (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') ? bit : 0;
+                masks.whitespace |= isWhitespace(c) ? bit : 0;
+                masks.unusual |= (static_cast<uint8_t>(c) < 0x20 || static_cast<uint8_t>(c) >= 0x80) ? bit : 0;
+            }
+            return masks;
+        }
+#endif
+
+        /// @return every bit set if an odd number of bits at or below its position is set
+        inline uint64_t prefixXor(uint64_t bits) noexcept
+        {
+#if defined(__PCLMUL__)
+            return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(bits)), _mm_set1_epi8(-1), 0)));
+#else
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+            return bits;
+#endif
+        }
+
+        /// @return characters preceded by an odd number of backslashes, carry tracks a run crossing the block end
+        inline uint64_t escapedCharacters(uint64_t backslash, uint64_t &carry) noexcept
+        {
+            constexpr uint64_t evenBits {0x5555555555555555ull};
+            backslash &= ~carry;
+            const uint64_t followsEscape {(backslash << 1) | carry};
+            const uint64_t oddSequenceStarts {backslash & ~evenBits & ~followsEscape};
+            uint64_t sequencesStartingOnEvenBits {0};
+            carry = __builtin_add_overflow(oddSequenceStarts, backslash, &sequencesStartingOnEvenBits) ? 1 : 0;
+            const uint64_t invertMask {sequencesStartingOnEvenBits << 1};
+            return (evenBits ^ invertMask) & followsEscape;
+        }
+    } // namespace priv
+
+    ///
+    /// Token stream over a runtime buffer.
+    /// A first pass classifies the input 64 bytes at a time (SIMD when available)
+    /// and records where every token starts, next() then only classifies the bytes at those positions.
+    /// Produces the same tokens as classifyToken, input of 4 GB and more is tokenized byte by byte.
+    ///
+    class JSONStructuralIndex
+    {
+    public:
+        /// empty index, reset() points it at an input
+        JSONStructuralIndex() noexcept = default;
+
+        JSONStructuralIndex(const char *str, size_t length)
+        {
+            reset(str, length);
+        }
+
+        /// indexes another input from the start, the buffers of the previous input are reused when large enough
+        void reset(const char *str, size_t length)
+        {
+            input_ = str;
+            length_ = length;
+            indexed_ = (length_ <= UINT32_MAX);
+            count_ = 0;
+            cursor_ = 0;
+            pos_ = 0;
+            resumeAt_ = npos;
+            if (indexed_) {
+                build();
+            }
+        }
+
+        /// @return number of recorded positions, opening and closing quotes count separately
+        size_t size() const noexcept
+        {
+            return count_;
+        }
+
+        JSONToken next() noexcept
+        {
+            if (resumeAt_ == npos && cursor_ + 1 < count_) {
+                const size_t pos {positions_[cursor_]};
+                const char c {input_[pos]};
+                if (c == '"') {
+                    cursor_ += 2;
+                    return stringToken(pos, positions_[cursor_ - 1]);
+                }
+                const TokenType type {structuralType(c)};
+                ++cursor_;
+                return (type != TokenType::Invalid) ? JSONToken{ type, pos, 1 } : nextAtom(pos);
+            }
+            return slowNext();
+        }
+
+    private:
+        static constexpr size_t npos {static_cast<size_t>(-1)};
+
+        void build()
+        {
+            // enough for typical documents, which have a token every three bytes or more
+            const size_t capacity {length_ / 2 + 64};
+            if (capacity > capacity_) {
+                positions_.reset(new uint32_t[capacity]);
+                capacity_ = capacity;
+            }
+            const size_t blocks {(length_ + 63) / 64};
+            const size_t dirtyWords {(blocks + 63) / 64};
+            if (!dirty_ || dirtyWords > dirtyWords_) {
+                dirty_.reset(new uint64_t[dirtyWords]());
+                dirtyWords_ = dirtyWords;
+            } else {
+                std::memset(dirty_.get(), 0, dirtyWords * sizeof(uint64_t));
+            }
+            uint64_t escapeCarry {0};
+            uint64_t inStringCarry {0};
+            uint64_t precedingCarry {1};
+            for (size_t offset = 0; offset < length_; offset += 64) {
+                const priv::JSONBlockMasks masks {classifyBlock(offset)};
+                const uint64_t escaped {priv::escapedCharacters(masks.backslash, escapeCarry)};
+                const uint64_t quotes {masks.quote & ~escaped};
+                // set from an opening quote up to, but not including, the closing quote
+                const uint64_t inString {priv::prefixXor(quotes) ^ inStringCarry};
+                inStringCarry = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+                const uint64_t structural {masks.structural & ~inString};
+                // strings in these blocks are validated when they are read
+                if (((masks.backslash | masks.unusual) & inString) != 0) {
+                    dirty_[offset / 64 / 64] |= uint64_t(1) << (offset / 64 % 64);
+                }
+                // atoms (numbers, literals) start after whitespace, structural characters or quotes
+                const uint64_t boundary {structural | masks.whitespace | quotes};
+                const uint64_t afterBoundary {(boundary << 1) | precedingCarry};
+                precedingCarry = boundary >> 63;
+                const uint64_t atoms {afterBoundary & ~boundary & ~inString};
+                append(offset, structural | quotes | atoms);
+            }
+        }
+
+        static TokenType structuralType(char c) noexcept
+        {
+            switch (c) {
+            case '{':
+                return TokenType::DictOpen;
+            case '}':
+                return TokenType::DictClose;
+            case '[':
+                return TokenType::ArrayOpen;
+            case ']':
+                return TokenType::ArrayClose;
+            case ':':
+                return TokenType::Colon;
+            case ',':
+                return TokenType::Comma;
+            default:
+                return TokenType::Invalid;
+            }
+        }
+
+        /// the last position, tokens after an error and input which is not indexed
+        JSONToken slowNext() noexcept
+        {
+            if (!indexed_) {
+                pos_ = skipWhitespace(input_, length_, pos_);
+                if (pos_ >= length_) {
+                    return { TokenType::Invalid, pos_, 0 };
+                }
+                const JSONToken token {classifyToken(input_, length_, pos_)};
+                pos_ += token.length;
+                return token;
+            }
+            if (resumeAt_ != npos) {
+                return nextAtom(resumeAt_);
+            }
+            if (cursor_ >= count_) {
+                return { TokenType::Invalid, length_, 0 };
+            }
+            const size_t pos {positions_[cursor_++]};
+            const TokenType type {structuralType(input_[pos])};
+            if (type != TokenType::Invalid) {
+                return { type, pos, 1 };
+            }
+            if (input_[pos] == '"' && cursor_ < count_) {
+                return stringToken(pos, positions_[cursor_++]);
+            }
+            // atom or unterminated string
+            return nextAtom(pos);
+        }
+
+        /// @return string between the quotes at pos and close, its contents are checked only if a block holds escapes,
+        /// control characters or multibyte characters
+        JSONToken stringToken(size_t pos, size_t close) noexcept
+        {
+            for (size_t block = pos / 64; block <= close / 64; ++block) {
+                if ((dirty_[block / 64] >> (block % 64)) & 1) {
+                    if (!isValidStringContent(input_ + pos + 1, close - pos - 1)) {
+                        resumeAt_ = pos;
+                        return { TokenType::Invalid, pos, 0 };
+                    }
+                    break;
+                }
+            }
+            return { TokenType::String, pos, close - pos + 1 };
+        }
+
+        /// numbers and literals, which end at the next recorded position or whitespace
+        JSONToken nextAtom(size_t pos) noexcept
+        {
+            const JSONToken token {classifyToken(input_, length_, pos)};
+            const size_t end {pos + token.length};
+            if (token.type == TokenType::Invalid) {
+                resumeAt_ = pos;
+            } else if (end < length_ && (cursor_ >= count_ || positions_[cursor_] != end) && !isWhitespace(input_[end])) {
+                // the token ends inside an atom, continue right after it like the byte by byte tokenizer does
+                resumeAt_ = end;
+            } else {
+                resumeAt_ = npos;
+            }
+            return token;
+        }
+
+        priv::JSONBlockMasks classifyBlock(size_t offset) const noexcept
+        {
+            if (offset + 64 <= length_) {
+                return priv::classifyBlock(input_ + offset);
+            }
+            char block[64];
+            std::memset(block, ' ', sizeof(block));
+            std::memcpy(block, input_ + offset, length_ - offset);
+            return priv::classifyBlock(block);
+        }
+
+        void append(size_t offset, uint64_t bits)
+        {
+            if (count_ + 64 > capacity_) {
+                std::unique_ptr<uint32_t[]> grown {new uint32_t[2 * capacity_]};
+                std::memcpy(grown.get(), positions_.get(), count_ * sizeof(uint32_t));
+                positions_ = std::move(grown);
+                capacity_ *= 2;
+            }
+            uint32_t *out {positions_.get() + count_};
+            const size_t count {static_cast<size_t>(__builtin_popcountll(bits))};
+            count_ += count;
+            // four positions per step without data dependent branches, surplus writes land in the slack
+            for (size_t i = 0; i < count; i += 4) {
+                for (size_t j = 0; j < 4; ++j) {
+                    out[i + j] = static_cast<uint32_t>(offset + static_cast<size_t>(__builtin_ctzll(bits | (uint64_t(1) << 63))));
+                    bits &= bits - 1;
+                }
+            }
+        }
+
+        const char *input_ {nullptr};
+        size_t length_ {0};
+        bool indexed_ {false};
+        std::unique_ptr<uint32_t[]> positions_;
+        /// one bit per 64 byte block
+        std::unique_ptr<uint64_t[]> dirty_;
+        size_t dirtyWords_ {0};
+        size_t capacity_ {0};
+        size_t count_ {0};
+        size_t cursor_ {0};
+        size_t pos_ {0};
+        size_t resumeAt_ {npos};
+    };
+} // namespace ctjson
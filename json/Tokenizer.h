@@ -0,0 +1,208 @@
+#pragma once
+
+#include "NumberUtils.h"
+#include "StringEscapes.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ctjson
+{
+    enum class TokenType : uint8_t {
+        String,
+        Number,
+        Boolean,
+        Null,
+        DictOpen,
+        DictClose,
+        ArrayOpen,
+        ArrayClose,
+        Colon,
+        Comma,
+        Invalid
+    };
+
+    /// Position of a single token in the input text
+    struct JSONToken
+    {
+        TokenType type {TokenType::Invalid};
+        size_t offset {0};
+        size_t length {0};
+    };
+
+    constexpr bool isWhitespace(char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    /// @return position of the first non-whitespace character at or after pos
+    constexpr size_t skipWhitespace(const char *str, size_t length, size_t pos) noexcept
+    {
+        while (pos < length && isWhitespace(str[pos])) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    namespace priv
+    {
+        template <size_t N>
+        constexpr bool matchesLiteral(const char *str, size_t length, size_t pos, const char (&literal)[N]) noexcept
+        {
+            if (pos + N - 1 > length) {
+                return false;
+            }
+            for (size_t i = 0; i < N - 1; ++i) {
+                if (str[pos + i] != literal[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // namespace priv
+
+    /// @return token starting at pos, TokenType::Invalid with zero length if the input is malformed
+    constexpr JSONToken classifyToken(const char *str, size_t length, size_t pos) noexcept
+    {
+        switch (str[pos]) {
+        case '{':
+            return { TokenType::DictOpen, pos, 1 };
+        case '}':
+            return { TokenType::DictClose, pos, 1 };
+        case '[':
+            return { TokenType::ArrayOpen, pos, 1 };
+        case ']':
+            return { TokenType::ArrayClose, pos, 1 };
+        case ':':
+            return { TokenType::Colon, pos, 1 };
+        case ',':
+            return { TokenType::Comma, pos, 1 };
+        case '"': {
+            const size_t stringLength {scanString(str, length, pos)};
+            return { stringLength != 0 ? TokenType::String : TokenType::Invalid, pos, stringLength };
+        }
+        case 't':
+            return priv::matchesLiteral(str, length, pos, "true") ? JSONToken{ TokenType::Boolean, pos, 4 } : JSONToken{ TokenType::Invalid, pos, 0 };
+        case 'f':
+            return priv::matchesLiteral(str, length, pos, "false") ? JSONToken{ TokenType::Boolean, pos, 5 } : JSONToken{ TokenType::Invalid, pos, 0 };
+        case 'n':
+            return priv::matchesLiteral(str, length, pos, "null") ? JSONToken{ TokenType::Null, pos, 4 } : JSONToken{ TokenType::Invalid, pos, 0 };
+        default:
+            break;
+        }
+        const size_t numberLength = scanNumber(str + pos, length - pos);
+        return { numberLength != 0 ? TokenType::Number : TokenType::Invalid, pos, numberLength };
+    }
+
+    namespace priv
+    {
+        /// @return end of the container opened at pos, only brackets outside of strings are tracked; 0 if it is not closed
+        constexpr size_t skipContainer(const char *str, size_t length, size_t pos) noexcept
+        {
+            size_t depth {0};
+            for (; pos < length; ++pos) {
+                switch (str[pos]) {
+                case '"':
+                    pos = findStringEnd(str, length, pos);
+                    break;
+                case '{':
+                case '[':
+                    ++depth;
+                    break;
+                case '}':
+                case ']':
+                    if (--depth == 0) {
+                        return pos + 1;
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+            return 0;
+        }
+
+        /// @return end of the value starting at pos, 0 if it is malformed
+        constexpr size_t skipValue(const char *str, size_t length, size_t pos) noexcept
+        {
+            if (pos >= length) {
+                return 0;
+            }
+            if (str[pos] == '{' || str[pos] == '[') {
+                return skipContainer(str, length, pos);
+            }
+            const JSONToken token {classifyToken(str, length, pos)};
+            return (token.type <= TokenType::Null && token.length != 0) ? pos + token.length : 0;
+        }
+
+        /// @return length of a '\0' terminated text
+        constexpr size_t textLength(const char *str) noexcept
+        {
+            size_t length {0};
+            while (str[length] != '\0') {
+                ++length;
+            }
+            return length;
+        }
+
+        /// @return position of the next item after a value of a container which ends at end, 0 if the container is malformed;
+        /// done is set at the closing bracket and the position after it is returned
+        constexpr size_t nextItem(const char *str, size_t length, size_t end, char close, bool &done) noexcept
+        {
+            const size_t pos {skipWhitespace(str, length, end)};
+            if (pos < length && str[pos] == ',') {
+                return skipWhitespace(str, length, pos + 1);
+            }
+            done = (pos < length && str[pos] == close);
+            return done ? pos + 1 : 0;
+        }
+
+        /// @return position of the first item of the container opened at pos; done is set if it is empty and the position after it is returned
+        constexpr size_t firstItem(const char *str, size_t length, size_t pos, char close, bool &done) noexcept
+        {
+            pos = skipWhitespace(str, length, pos + 1);
+            done = (pos < length && str[pos] == close);
+            return done ? pos + 1 : pos;
+        }
+
+        /// reads the name and colon of an object entry at pos
+        /// @return position of the value, 0 if the entry is malformed
+        constexpr size_t objectEntry(const char *str, size_t length, size_t pos, JSONToken &key) noexcept
+        {
+            key = (pos < length) ? classifyToken(str, length, pos) : JSONToken {};
+            if (key.type != TokenType::String) {
+                return 0;
+            }
+            pos = skipWhitespace(str, length, pos + key.length);
+            return (pos < length && str[pos] == ':') ? skipWhitespace(str, length, pos + 1) : 0;
+        }
+    } // namespace priv
+
+    /// @return number of tokens in the input, a malformed token is counted and ends the input
+    constexpr size_t countTokens(const char *str, size_t length) noexcept
+    {
+        size_t count = 0;
+        for (size_t pos = skipWhitespace(str, length, 0); pos < length; pos = skipWhitespace(str, length, pos)) {
+            const JSONToken token {classifyToken(str, length, pos)};
+            ++count;
+            if (token.type == TokenType::Invalid) {
+                break;
+            }
+            pos += token.length;
+        }
+        return count;
+    }
+
+    /// @return all tokens of the input, count has to be the result of countTokens
+    template <size_t count>
+    constexpr std::array<JSONToken, count> tokenize(const char *str, size_t length) noexcept
+    {
+        std::array<JSONToken, count> tokens {};
+        size_t pos = skipWhitespace(str, length, 0);
+        for (size_t i = 0; i < count; ++i) {
+            tokens[i] = classifyToken(str, length, pos);
+            pos = skipWhitespace(str, length, pos + tokens[i].length);
+        }
+        return tokens;
+    }
+} // namespace ctjson
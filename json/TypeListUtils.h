@@ -1,12 +1,65 @@
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
+#include <utility>
+
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define CTJSON_HAS_TYPE_PACK_ELEMENT 1
+#endif
+#endif
 
 namespace ctjson
 {
 	template <typename... Args>
 	class TypeList;
 
+	namespace priv
+	{
+#if defined(__cpp_pack_indexing)
+		template <size_t idx, typename... Args>
+		using PackElement = Args...[idx];
+#elif defined(CTJSON_HAS_TYPE_PACK_ELEMENT)
+		template <size_t idx, typename... Args>
+		using PackElement = __type_pack_element<idx, Args...>;
+#else
+		template <size_t idx, typename T>
+		struct IndexedType
+		{
+			using type = T;
+		};
+
+		template <typename Indices, typename... Args>
+		struct IndexedPack;
+
+		/// every type as a base tagged with its index, selected by overload resolution instead of recursing through the list
+		template <size_t... indices, typename... Args>
+		struct IndexedPack<std::index_sequence<indices...>, Args...> : IndexedType<indices, Args>...
+		{
+		};
+
+		template <size_t idx, typename T>
+		IndexedType<idx, T> selectIndexed(const IndexedType<idx, T> &);
+
+		template <size_t idx, typename... Args>
+		using PackElement = typename decltype(selectIndexed<idx>(std::declval<IndexedPack<std::index_sequence_for<Args...>, Args...>>()))::type;
+#endif
+
+		/// type at idx, std::false_type past the end; the instantiation depth does not grow with the list
+		template <bool inRange, size_t idx, typename... Args>
+		struct TypeListAt
+		{
+			using type = std::false_type;
+		};
+
+		template <size_t idx, typename... Args>
+		struct TypeListAt<true, idx, Args...>
+		{
+			using type = PackElement<idx, Args...>;
+		};
+	} // namespace priv
+
 	class EmptyTypeList {
 	public:
 		using type = std::false_type;
@@ -45,10 +98,11 @@ namespace ctjson
 		template <typename U>
 		using Append = TypeList<T, Args..., U>;
 
-		static constexpr size_t length{ 1 + next::length };
+		// taken from the pack, so the tails of the list are only instantiated when used
+		static constexpr size_t length{ 1 + sizeof...(Args) };
 
 		template <size_t idx>
-		using At = std::conditional_t<idx == 0, T, typename next::template At<idx - 1>>;
+		using At = typename priv::TypeListAt<(idx < length), idx, T, Args...>::type;
 	};
 
     template <typename ... Args>
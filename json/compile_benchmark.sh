@@ -0,0 +1,184 @@
+#!/bin/bash
+# Compile cost of ctjson on generated documents of growing size and different shapes:
+#   flat   - one object with many small entries
+#   deep   - objects nested in each other
+#   array  - one long array of integers
+#   string - one entry with a long string value
+# Modes: "load" only reads the document into a constexpr array, "tokenize" builds JSONTokenArray only,
+# "parse" runs the whole JSONParser, "declare" also creates the constexpr object tree.
+# Documents are raw string literals, with EMBED set they are headers generated by embed_json.sh instead.
+# Every row reports wall time, peak compiler RSS and, for clang, the number of template instantiations
+# taken from -ftime-trace. GCC has no equivalent, its count is "n/a".
+# Compilations are capped at TIMEOUT seconds and reported as "timeout" past that.
+# With BASELINE set to the output of an earlier run, rows more than TOLERANCE percent (and a quarter second)
+# slower are listed on stderr and the script exits with status 1.
+# usage: [SIZES="1024 10240"] [SHAPES="flat array"] [EMBED=1] [BASELINE=old.csv] ./compile_benchmark.sh [compiler...]
+COMPILERS=("${@:-g++}")
+if [[ $# -eq 0 ]] && command -v clang++ > /dev/null; then
+	COMPILERS+=(clang++)
+fi
+TIMEOUT=${TIMEOUT:-120}
+SIZES=${SIZES:-1024 10240 102400}
+SHAPES=${SHAPES:-flat deep array string}
+TOLERANCE=${TOLERANCE:-20}
+SRC_DIR=$(cd "$(dirname "$0")" && pwd)
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+generate_flat() {
+	awk -v size="$1" 'BEGIN {
+		out = "{"
+		for (i = 0; length(out) < size; ++i)
+			out = out (i ? ", " : "") "\"key" i "\": " i
+		print out "}"
+	}'
+}
+
+generate_deep() {
+	awk -v size="$1" 'BEGIN {
+		depth = int(size / 10)
+		for (i = 0; i < depth; ++i)
+			printf "{\"a\": "
+		printf "0"
+		for (i = 0; i < depth; ++i)
+			printf "}"
+		print ""
+	}'
+}
+
+generate_array() {
+	awk -v size="$1" 'BEGIN {
+		out = "["
+		for (i = 0; length(out) < size; ++i)
+			out = out (i ? ", " : "") i
+		print out "]"
+	}'
+}
+
+generate_string() {
+	awk -v size="$1" 'BEGIN {
+		out = "{\"text\": \""
+		while (length(out) < size)
+			out = out "lorem ipsum "
+		print out "\"}"
+	}'
+}
+
+# runs the command, prints "exit_status seconds peak_rss_kb"
+measure() {
+	if [[ -x /usr/bin/time ]]; then
+		local start end status
+		start=$(date +%s.%N)
+		/usr/bin/time -f "%M" -o "$WORK_DIR/rss" "$@" > /dev/null 2>&1
+		status=$?
+		end=$(date +%s.%N)
+		awk -v s="$start" -v e="$end" -v status="$status" -v rss="$(tail -n 1 "$WORK_DIR/rss")" \
+			'BEGIN { printf "%d %.2f %s\n", status, e - s, rss }'
+	elif command -v python3 > /dev/null; then
+		python3 -c '
+import resource, subprocess, sys, time
+start = time.time()
+status = subprocess.run(sys.argv[1:], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL).returncode
+print(status, "%.2f" % (time.time() - start), resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss)' "$@"
+	else
+		local start end status
+		start=$(date +%s.%N)
+		"$@" > /dev/null 2>&1
+		status=$?
+		end=$(date +%s.%N)
+		awk -v s="$start" -v e="$end" -v status="$status" 'BEGIN { printf "%d %.2f n/a\n", status, e - s }'
+	fi
+}
+
+# prints "seconds,peak_rss_kb,instantiations" of one compilation
+compile() {
+	local compiler=$1
+	shift
+	local flags=(-std=c++17 -ftemplate-depth=100000 -fconstexpr-depth=100000 -I"$SRC_DIR")
+	local trace=""
+	if [[ "$compiler" == *clang* ]]; then
+		# the trace is written next to the object file
+		flags+=(-fconstexpr-steps=1000000000 -ftime-trace -ftime-trace-granularity=0 -c -o "$WORK_DIR/unit.o")
+		trace="$WORK_DIR/unit.json"
+		rm -f "$trace"
+	else
+		flags+=(-fconstexpr-ops-limit=1000000000 -fconstexpr-loop-limit=100000000 -fsyntax-only)
+	fi
+	local result status seconds rss
+	result=$(measure timeout "$TIMEOUT" "$compiler" "${flags[@]}" "$@")
+	read -r status seconds rss <<< "$result"
+	if [[ $status -eq 124 ]]; then
+		echo "timeout,n/a,n/a"
+	elif [[ $status -ne 0 ]]; then
+		echo "failed,n/a,n/a"
+	elif [[ -n "$trace" && -f "$trace" ]]; then
+		echo "$seconds,$rss,$(grep -o '"name":"Instantiate\(Class\|Function\)"' "$trace" | wc -l)"
+	else
+		echo "$seconds,$rss,n/a"
+	fi
+}
+
+write_source() {
+	local shape=$1 size=$2 source_file=$3
+	if [[ -n "$EMBED" ]]; then
+		"generate_$shape" "$size" > "${source_file%.cpp}.json"
+		"$SRC_DIR/embed_json.sh" "${source_file%.cpp}.json" doc "${source_file%.cpp}.h"
+	fi
+	{
+		echo '#include "CTJson.h"'
+		if [[ -n "$EMBED" ]]; then
+			echo "#include \"$(basename "${source_file%.cpp}.h")\""
+		else
+			echo 'static constexpr const char doc[] = R"JSON('
+			"generate_$shape" "$size"
+			echo ')JSON";'
+		fi
+		echo 'using Input = ctjson::JSONText<doc>;'
+		echo '#if defined(LOAD)'
+		echo 'static_assert(sizeof(doc) > 1);'
+		echo '#elif defined(DECLARE)'
+		echo 'using Parser = ctjson::JSONParser<Input>;'
+		echo 'static constexpr auto tree {ctjson::JSONDeclarator<Parser::Result>::createObject()};'
+		echo '#elif defined(PARSE)'
+		echo 'static_assert(ctjson::JSONParser<Input>::success);'
+		echo '#else'
+		echo 'static_assert(ctjson::JSONTokenArray<Input>::count > 0);'
+		echo '#endif'
+	} > "$source_file"
+}
+
+run() {
+	echo "compiler,shape,size_bytes,mode,seconds,peak_rss_kb,instantiations"
+	for compiler in "${COMPILERS[@]}"; do
+		for shape in $SHAPES; do
+			for size in $SIZES; do
+				local source_file="$WORK_DIR/${shape}_$size.cpp"
+				write_source "$shape" "$size" "$source_file"
+				echo "$compiler,$shape,$size,load,$(compile "$compiler" -DLOAD "$source_file")"
+				echo "$compiler,$shape,$size,tokenize,$(compile "$compiler" "$source_file")"
+				echo "$compiler,$shape,$size,parse,$(compile "$compiler" -DPARSE "$source_file")"
+				echo "$compiler,$shape,$size,declare,$(compile "$compiler" -DDECLARE "$source_file")"
+			done
+		done
+	done
+}
+
+if [[ -z "$BASELINE" ]]; then
+	run
+	exit 0
+fi
+run | tee "$WORK_DIR/current.csv"
+# a timeout or failure that used to compile counts as a regression as well
+awk -F, -v tolerance="$TOLERANCE" '
+	FNR == 1 { next }
+	NR == FNR { baseline[$1 "," $2 "," $3 "," $4] = $5; next }
+	{
+		key = $1 "," $2 "," $3 "," $4
+		if (!(key in baseline) || baseline[key] !~ /^[0-9.]+$/)
+			next
+		if ($5 !~ /^[0-9.]+$/ || ($5 > baseline[key] * (1 + tolerance / 100) && $5 > baseline[key] + 0.25)) {
+			print "regression: " key " " baseline[key] " -> " $5 > "/dev/stderr"
+			failed = 1
+		}
+	}
+	END { exit failed }' "$BASELINE" "$WORK_DIR/current.csv"
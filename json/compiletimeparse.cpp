@@ -1,5 +1,24 @@
 #include "CTJson.h"
+#include "JSONBinding.h"
+#include "JSONDocument.h"
+#include "JSONFlatTable.h"
+#include "JSONLines.h"
+#include "JSONMerge.h"
+#include "JSONOnDemand.h"
+#include "JSONPointer.h"
+#include "JSONReader.h"
+#include "JSONSchema.h"
+#include "JSONWriter.h"
+#include <atomic>
+#include <charconv>
+#include <cassert>
+#include <cfloat>
+#include <cstring>
 #include <iostream>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <vector>
 
 using namespace ctjson;
 
@@ -57,6 +76,31 @@ static void testTokenizer()
     static_assert(std::is_same_v<EndMarker, std::false_type>, "");
 }
 
+static constexpr const char tokenTest_Literals[] = " [true, false,\r\n null] ";
+static void testTokenArray()
+{
+    using Input = String<tokenTest_Literals, 0, sizeof(tokenTest_Literals) - 1>;
+    using Tokens = JSONTokenArray<Input>;
+    static_assert(Tokens::count == 7);
+    static_assert(Tokens::tokens[0].type == TokenType::ArrayOpen);
+    static_assert(Tokens::tokens[0].offset == 1);
+    static_assert(Tokens::tokens[1].type == TokenType::Boolean);
+    static_assert(Tokens::tokens[1].length == 4);
+    static_assert(Tokens::tokens[3].type == TokenType::Boolean);
+    static_assert(Tokens::tokens[3].offset == 8);
+    static_assert(Tokens::tokens[3].length == 5);
+    static_assert(Tokens::tokens[5].type == TokenType::Null);
+    static_assert(Tokens::tokens[6].type == TokenType::ArrayClose);
+
+    using TokenList = JSONTokenizer<Input>;
+    static_assert(TokenList::At<3>::Token::equals("false"));
+    static_assert(TokenList::At<4>::type == TokenType::Comma);
+
+    constexpr const char malformed[] = "{\"a\" : tru }";
+    static_assert(countTokens(malformed, sizeof(malformed) - 1) == 4);
+    static_assert(tokenize<4>(malformed, sizeof(malformed) - 1)[3].type == TokenType::Invalid);
+}
+
 static void testJSONNVParser() noexcept
 {
     using Input = String<jsonNameVal, 0, sizeof(jsonNameVal) - 1>;
@@ -229,6 +273,973 @@ static void testObjectParseValueArray()
     static_assert (values[2] == 3);
 }
 
+static constexpr const char tokenTest_Numbers[] = "[-12, 0.5, 1e3, -2.5E-2, 0]";
+static void testNumberTokens()
+{
+    using Input = String<tokenTest_Numbers, 0, sizeof(tokenTest_Numbers) - 1>;
+    using TokenList = JSONTokenizer<Input>;
+    static_assert(TokenList::At<1>::type == TokenType::Number);
+    static_assert(TokenList::At<1>::Token::equals("-12"));
+    static_assert(TokenList::At<3>::Token::equals("0.5"));
+    static_assert(TokenList::At<5>::Token::equals("1e3"));
+    static_assert(TokenList::At<7>::Token::equals("-2.5E-2"));
+    static_assert(TokenList::At<9>::Token::equals("0"));
+    static_assert(TokenList::At<10>::type == TokenType::ArrayClose);
+
+    static_assert(TokenList::At<1>::Token::toInt() == -12);
+    static_assert(TokenList::At<1>::Token::isInteger());
+    static_assert(!TokenList::At<3>::Token::isInteger());
+    static_assert(TokenList::At<3>::Token::toDouble() == 0.5);
+    static_assert(TokenList::At<5>::Token::toDouble() == 1000.0);
+    static_assert(TokenList::At<7>::Token::toDouble() == -0.025);
+
+    static_assert(scanNumber("-", 1) == 0);
+    static_assert(scanNumber("01", 2) == 1);
+    static_assert(scanNumber("1.", 2) == 0);
+    static_assert(scanNumber("1e+", 3) == 0);
+    static_assert(scanNumber("-0.0e-0,", 8) == 7);
+    static_assert(parseInt64("-9223372036854775808", 20) == INT64_MIN);
+    static_assert(parseInt64("9007199254740993", 16) == 9007199254740993);
+
+    // correctly rounded conversion, including halfway and subnormal cases
+    static_assert(parseDouble("9007199254740993", 16) == 9007199254740992.0);
+    static_assert(parseDouble("9007199254740995", 16) == 9007199254740996.0);
+    static_assert(parseDouble("2.2250738585072014e-308", 23) == DBL_MIN);
+    static_assert(parseDouble("1.7976931348623157e308", 22) == DBL_MAX);
+    static_assert(parseDouble("4.9e-324", 8) == DBL_TRUE_MIN);
+    static_assert(parseDouble("2.4703282292062327e-324", 23) == 0.0);
+    static_assert(parseDouble("2.4703282292062328e-324", 23) == DBL_TRUE_MIN);
+    static_assert(parseDouble("1e400", 5) == std::numeric_limits<double>::infinity());
+    static_assert(parseDouble("0.1000000000000000055511151231257827021181583404541015625", 57) == 0.1);
+}
+
+static constexpr const char tokenTest_WideIntegers[] = R"TAG(
+{
+    "small": -2147483648,
+    "wide": 2147483648,
+    "min": -9223372036854775808,
+    "unsigned": 18446744073709551615,
+    "ids": [1, 4294967296, -3],
+    "hashes": [18446744073709551615, 0],
+    "mixed": [-1, 18446744073709551615],
+    "scaled": [5000000000, 2.5, 18446744073709551615, -9223372036854775808]
+}
+)TAG";
+static constexpr auto tokenTest_WideTree {JSONDeclarator<JSONParser<String<tokenTest_WideIntegers, 0, sizeof(tokenTest_WideIntegers) - 1>>::Result>::createObject()};
+static constexpr const char tokenTest_WideIds[] = "/ids";
+static constexpr const char tokenTest_WideHashes[] = "/hashes";
+static constexpr const char tokenTest_WideMixed[] = "/mixed/1";
+static constexpr const char tokenTest_WideScaled[] = "/scaled";
+static constexpr const char tokenTest_SingleEntry[] = "{\"a\": 5}";
+static constexpr const char tokenTest_SingleWide[] = "{\"a\": 5000000000}";
+static constexpr const char tokenTest_TwoEntries[] = "{\"a\": 5, \"b\": 5000000000}";
+static constexpr auto tokenTest_SingleTree {JSONDeclarator<JSONParser<JSONText<tokenTest_SingleEntry>>::Result>::createObject()};
+static constexpr auto tokenTest_SingleWideTree {JSONDeclarator<JSONParser<JSONText<tokenTest_SingleWide>>::Result>::createObject()};
+static constexpr auto tokenTest_TwoTree {JSONDeclarator<JSONParser<JSONText<tokenTest_TwoEntries>>::Result>::createObject()};
+static void testWideIntegers()
+{
+    // scalars convert by their value whatever the shape of the tree: single entry, hashed dict or linear search
+    static_assert(tokenTest_SingleTree.get<uint64_t>("\"a\"") == 5u && tokenTest_TwoTree.get<uint64_t>("\"a\"") == 5u);
+    static_assert(tokenTest_TwoTree.entries().get<uint64_t>("\"a\"") == 5u);
+    static_assert(tokenTest_SingleWideTree.get<double>("\"a\"") == 5e9 && tokenTest_TwoTree.get<double>("\"b\"") == 5e9);
+    static_assert(tokenTest_TwoTree.entries().get<double>("\"b\"") == 5e9);
+    static_assert(tokenTest_SingleWideTree.get<int32_t>("\"a\"") == 0 && tokenTest_TwoTree.get<int32_t>("\"b\"") == 0);
+    static_assert(tokenTest_TwoTree.entries().get<int32_t>("\"b\"") == 0);
+    static_assert(tokenTest_SingleTree.get<bool>("\"a\"") == false && tokenTest_TwoTree.entries().get<bool>("\"a\"") == false);
+
+    static_assert(integerRange("2147483647", 10) == IntegerRange::Int32);
+    static_assert(integerRange("-2147483649", 11) == IntegerRange::Int64);
+    static_assert(integerRange("9223372036854775808", 19) == IntegerRange::UInt64);
+    static_assert(integerRange("-9223372036854775809", 20) == IntegerRange::Overflow);
+    static_assert(integerRange("18446744073709551616", 20) == IntegerRange::Overflow);
+    static_assert(parseUInt64("18446744073709551615", 20) == UINT64_MAX);
+
+    // every integer gets the narrowest type holding it, a literal which fits none is a compile error
+    static_assert(tokenTest_WideTree.get<int32_t>("\"small\"") == INT32_MIN);
+    static_assert(tokenTest_WideTree.get<int64_t>("\"wide\"") == 2147483648);
+    static_assert(tokenTest_WideTree.get<int32_t>("\"wide\"") == 0);
+    static_assert(tokenTest_WideTree.get<int64_t>("\"min\"") == INT64_MIN);
+    static_assert(tokenTest_WideTree.get<uint64_t>("\"unsigned\"") == UINT64_MAX);
+    static_assert(std::is_same_v<std::decay_t<decltype(at<tokenTest_WideIds, tokenTest_WideTree>())>, std::array<int64_t, 3>>);
+    static_assert(std::is_same_v<std::decay_t<decltype(at<tokenTest_WideHashes, tokenTest_WideTree>())>, std::array<uint64_t, 2>>);
+    static_assert(at<tokenTest_WideIds, tokenTest_WideTree>()[1] == 4294967296);
+    static_assert(at<tokenTest_WideMixed, tokenTest_WideTree>().as<uint64_t>() == UINT64_MAX);
+    static_assert(!at<tokenTest_WideMixed, tokenTest_WideTree>().is<int64_t>());
+    // integers of every width next to a fractional number make a double array, as 32-bit ones do
+    static_assert(std::is_same_v<std::decay_t<decltype(at<tokenTest_WideScaled, tokenTest_WideTree>())>, std::array<double, 4>>);
+    static_assert(tokenTest_WideTree.get<std::array<double, 4>>("\"scaled\"").value()[0] == 5e9);
+    static_assert(at<tokenTest_WideScaled, tokenTest_WideTree>()[2] == 18446744073709551615.0 && at<tokenTest_WideScaled, tokenTest_WideTree>()[3] == -9223372036854775808.0);
+    constexpr auto wideText {serializeJSON<tokenTest_WideTree>()};
+    assert(std::string(wideText.data()).find("\"unsigned\":18446744073709551615,\"ids\":[1,4294967296,-3]") != std::string::npos);
+
+    // the runtime digit parser takes eight digits at a time, it has to agree with the constexpr one
+    std::mt19937_64 random {7};
+    for (int i = 0; i < 10000; ++i) {
+        std::string text {std::to_string(random() >> (random() % 64))};
+        if (i % 2 != 0) {
+            text.insert(0, 1, '-');
+        }
+        char *end {};
+        const bool negative {text[0] == '-'};
+        const uint64_t expected {std::strtoull(text.c_str() + negative, &end, 10)};
+        assert(parseInt64(text.data(), text.size()) == static_cast<int64_t>(negative ? 0 - expected : expected));
+        assert(parseUInt64(text.data() + negative, text.size() - negative) == expected);
+        assert(integerRange(text.data(), text.size()) != IntegerRange::Overflow || (negative && expected > static_cast<uint64_t>(INT64_MAX) + 1));
+    }
+    assert(integerRange("99999999999999999999", 20) == IntegerRange::Overflow);
+    assert(integerRange("00000000000000000000018446744073709551615", 41) == IntegerRange::UInt64);
+
+    // runtime documents keep integers up to uint64_t, beyond that as double, and convert them like JSONScalar
+    const JSONDocument document {std::string("[9223372036854775807, 9223372036854775808, 5000000000, -7, 99999999999999999999, 2.5]")};
+    assert(document.root()[0].as<int64_t>() == INT64_MAX && document.root()[0].as<uint64_t>() == static_cast<uint64_t>(INT64_MAX));
+    assert(document.root()[1].type() == JSONNode::Type::Integer);
+    assert(document.root()[1].as<uint64_t>() == 9223372036854775808u && document.root()[1].as<int64_t>() == 0);
+    assert(document.root()[2].as<int32_t>() == 0 && document.root()[2].as<int64_t>() == 5000000000);
+    assert(document.root()[2].as<double>() == 5e9 && document.root()[0].as<double>() == 0.0);
+    assert(document.root()[3].as<int32_t>() == -7 && document.root()[3].as<uint64_t>() == 0u && document.root()[3].as<double>() == -7.0);
+    assert(document.root()[4].type() == JSONNode::Type::Number && document.root()[4].as<double>() == 1e20 && document.root()[4].as<uint64_t>() == 0u);
+    assert(document.root()[5].as<double>() == 2.5 && document.root()[5].as<int32_t>() == 0);
+}
+
+static constexpr const char tokenTest_ObjectDef_nestedArrays[] = R"TAG(
+{
+    "matrix": [[1, 2, 3], [4, 5, 6]],
+    "scales": [1, 0.5, -2e1],
+    "any": [1, "two", true, null],
+    "flags": [true, false],
+    "points": [{ "x": 1 }, { "x": 2 }],
+    "empty": []
+}
+)TAG";
+static constexpr const char tokenTest_RootArray[] = "[[\"a\", \"b\"], [\"c\", \"d\"]]";
+static constexpr const char tokenTest_MixedObjects[] = "{\"a\": [1, [{\"b\": 2}]]}";
+static void testNestedArrays()
+{
+    using Input = String<tokenTest_ObjectDef_nestedArrays, 0, sizeof(tokenTest_ObjectDef_nestedArrays) - 1>;
+    using Parser = JSONParser<Input>;
+    static_assert(Parser::success);
+
+    using Matrix = Parser::Result::type::value;
+    static_assert(Matrix::length == 2);
+    static_assert(Matrix::shape.depth == 2);
+    static_assert(Matrix::At<1>::length == 3);
+    static_assert(Matrix::At<1>::At<2>::String::toInt() == 6);
+    static_assert(std::is_same_v<Matrix::At<2>, std::false_type>);
+    static_assert(std::is_same_v<Matrix::ObjectType, std::array<std::array<int32_t, 3>, 2>>);
+
+    constexpr auto json_obj { JSONDeclarator<Parser::Result>::createObject() };
+    constexpr auto matrix { json_obj.get<Matrix::ObjectType>("\"matrix\"").value() };
+    static_assert(matrix[0][0] == 1 && matrix[0][2] == 3 && matrix[1][0] == 4 && matrix[1][2] == 6);
+
+    constexpr std::array<double, 3> scales { json_obj.get<std::array<double, 3>>("\"scales\"").value() };
+    static_assert(scales[0] == 1.0 && scales[1] == 0.5 && scales[2] == -20.0);
+
+    constexpr std::array<JSONScalar, 4> any { json_obj.get<std::array<JSONScalar, 4>>("\"any\"").value() };
+    static_assert(any[0].as<int32_t>() == 1);
+    static_assert(any[1].as<StringView>().value().equals("\"two\""));
+    static_assert(any[2].as<bool>());
+    static_assert(!any[3].is<int32_t>() && !any[3].is<StringView>());
+
+    constexpr std::array<bool, 2> flags { json_obj.get<std::array<bool, 2>>("\"flags\"").value() };
+    static_assert(flags[0] && !flags[1]);
+    using Points = Parser::Result::At<4>::value;
+    static_assert(Points::At<1>::type::value::String::toInt() == 2);
+    constexpr auto points { Points::createObject() };
+    static_assert(points[0].value() == 1 && points[1].value() == 2);
+    static_assert(json_obj.get<std::array<JSONScalar, 0>>("\"empty\"").value().size() == 0);
+
+    // arrays mixing objects with other values parse, but declaring them fails instead of dropping the objects:
+    // "objects can not be mixed with other values or nested arrays in one array";
+    // [{"b": 2}, {"c": true}] fails on "objects in one array need the same member names and types"
+    using MixedObjects = JSONParser<JSONText<tokenTest_MixedObjects>>::Result::type::value;
+    static_assert(MixedObjects::shape.objects && MixedObjects::shape.kind == priv::JSONLeafKind::Mixed);
+    static_assert(Matrix::shape.objects == false && Points::shape.objects && Points::shape.kind == priv::JSONLeafKind::Object);
+
+    using RootInput = String<tokenTest_RootArray, 0, sizeof(tokenTest_RootArray) - 1>;
+    using RootParser = JSONParser<RootInput>;
+    static_assert(RootParser::success);
+    constexpr auto root { RootParser::Result::createObject() };
+    static_assert(root.size() == 2 && root[1][0].equals("\"c\""));
+
+    static_assert(!ParseJSONArray<JSONTokenizer<String<tokenTest_Numbers, 0, sizeof(tokenTest_Numbers) - 2>>>::success);
+}
+
+static constexpr const char tokenTest_ObjectDef_numbers[] = "{ \"offset\" : -3, \"scale\" : 1.25e-1 }";
+static void testObjectParseNumbers()
+{
+    using Input = String<tokenTest_ObjectDef_numbers, 0, sizeof(tokenTest_ObjectDef_numbers) - 1>;
+    using Parser = JSONParser<Input>;
+    static_assert(Parser::success);
+
+    constexpr auto json_obj { JSONDeclarator<Parser::Result>::createObject() };
+    static_assert (json_obj.get<int32_t>("\"offset\"") == -3);
+    static_assert (json_obj.get<double>("\"scale\"") == 0.125);
+}
+
+static constexpr const char tokenTest_ObjectDef_lookup[] = R"TAG(
+{
+    "id": 7,
+    "name": "outer",
+    "inner": { "name": "inner", "depth": 2 },
+    "depth": 1,
+    "flags": [1, 2]
+}
+)TAG";
+static constexpr const char keyIndexTest_Letters[] = "abcdefghijklmnopqrstuvwxyz";
+static void testDictKeyIndex()
+{
+    using Input = String<tokenTest_ObjectDef_lookup, 0, sizeof(tokenTest_ObjectDef_lookup) - 1>;
+    using Parser = JSONParser<Input>;
+    static_assert(Parser::success);
+
+    constexpr auto json_obj { JSONDeclarator<Parser::Result>::createObject() };
+    static_assert (json_obj.contains("\"id\""));
+    static_assert (json_obj.contains("\"flags\""));
+    static_assert (json_obj.contains("\"depth\""));
+    static_assert (!json_obj.contains("\"nope\""));
+    static_assert (!json_obj.contains("id"));
+    static_assert (json_obj.get<int32_t>("\"id\"") == 7);
+    static_assert (json_obj.get<int32_t>("\"nope\"") == 0);
+
+    // names are matched depth first, as with the linear search
+    static_assert (json_obj.get<StringView>("\"name\"").value().equals("\"outer\""));
+    static_assert (json_obj.get<int32_t>("\"depth\"") == 2);
+    static_assert (json_obj.entries().get<int32_t>("\"depth\"") == 2);
+    static_assert (json_obj.get<std::array<int32_t, 2>>("\"flags\"").value()[1] == 2);
+
+    constexpr auto inner { json_obj.next().next().node().value() };
+    static_assert (inner.get<StringView>("\"name\"").value().equals("\"inner\""));
+    static_assert (!inner.contains("\"id\""));
+
+    constexpr JSONKeyIndex<26> index { []() constexpr {
+        std::array<StringView, 26> result {};
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = StringView(keyIndexTest_Letters + i, 1);
+        }
+        return result;
+    }() };
+    static_assert (index.valid());
+    static_assert (index.find("a") == 0);
+    static_assert (index.find("q") == 16);
+    static_assert (index.find("z") == 25);
+    static_assert (index.find("ab") == index.npos);
+}
+
+static void testRuntimeDocument()
+{
+    const std::string text {tokenTest_ObjectDef_lookup};
+    const JSONDocument document {text};
+    assert(document.success());
+    assert(document.root().type() == JSONNode::Type::Object);
+    assert(document.root().size() == 5);
+    assert(document.root().name(1).equals("\"name\""));
+
+    // same lookup rules as the compile time JSONDict
+    constexpr auto json_obj { JSONDeclarator<JSONParser<String<tokenTest_ObjectDef_lookup, 0, sizeof(tokenTest_ObjectDef_lookup) - 1>>::Result>::createObject() };
+    assert(document.get<int32_t>("\"id\"") == json_obj.get<int32_t>("\"id\""));
+    assert(document.get<int32_t>("\"depth\"") == json_obj.get<int32_t>("\"depth\""));
+    assert(document.get<StringView>("\"name\"").value().equals("\"outer\""));
+    assert(document.get<double>("\"id\"") == json_obj.get<double>("\"id\"") && document.get<double>("\"id\"") == 7.0);
+    assert(!document.contains("\"nope\""));
+
+    const JSONNode *flags {document.root().find("\"flags\"")};
+    assert(flags != nullptr && flags->type() == JSONNode::Type::Array);
+    assert(flags->size() == 2);
+    assert((*flags)[1].as<int32_t>() == 2);
+
+    constexpr const char nested[] = "[{\"a\": [1.5, true, null]}, [], {}]";
+    const JSONDocument nestedDocument {nested, sizeof(nested) - 1};
+    assert(nestedDocument.success());
+    assert(nestedDocument.root()[0].find("\"a\"")->size() == 3);
+    assert((*nestedDocument.root()[0].find("\"a\""))[0].as<double>() == 1.5);
+    assert((*nestedDocument.root()[0].find("\"a\""))[1].as<bool>());
+    assert(nestedDocument.root()[1].size() == 0);
+    assert(nestedDocument.root()[2].type() == JSONNode::Type::Object);
+    assert(nestedDocument.root()[2].find("\"a\"") == nullptr);
+
+    // names are interned once per document, lookups by id compare integers
+    constexpr const char repeated[] = "[{\"x\": 1, \"y\": 2}, {\"y\": 3, \"x\": 4, \"z\": {\"x\": 5}}]";
+    const JSONDocument repeatedDocument {repeated, sizeof(repeated) - 1};
+    const JSONKeyPool &keys {repeatedDocument.keys()};
+    assert(keys.size() == 3);
+    assert(keys.find("\"y\"") == 1 && keys.name(2).equals("\"z\""));
+    assert(keys.find("\"w\"") == JSONKeyPool::npos);
+    assert(repeatedDocument.root()[1].keyId(0) == keys.find("\"y\""));
+    assert(repeatedDocument.root()[1].name(1).equals("\"x\""));
+    assert(repeatedDocument.root()[1].get<int32_t>(keys.find("\"x\"")) == 4);
+    assert(repeatedDocument.root()[1][2].get<int32_t>(keys.find("\"x\"")) == 5);
+    assert(repeatedDocument.root()[0].find(keys.find("\"z\"")) == nullptr);
+
+    // the pool refers to the names, they have to stay in place
+    std::vector<std::string> names;
+    for (size_t i = 0; i < 1000; ++i) {
+        names.push_back("\"key" + std::to_string(i % 700) + '"');
+    }
+    JSONKeyPool pool;
+    for (size_t i = 0; i < names.size(); ++i) {
+        const uint32_t id {pool.intern(names[i].data(), names[i].size())};
+        assert(id == i % 700 && pool.name(id).equals(StringView(names[i].data(), names[i].size())));
+    }
+    assert(pool.size() == 700 && pool.find("\"key699\"") == 699);
+    pool.clear();
+    assert(pool.size() == 0 && pool.find("\"key1\"") == JSONKeyPool::npos);
+
+    for (const char *malformed : { "{\"a\" 1}", "[1, ]", "{\"a\": 1} 2", "[", "", "{\"a\": tru}" }) {
+        assert(!JSONDocument(malformed, std::strlen(malformed)).success());
+    }
+    assert(JSONDocument("{\"a\": 1} 2", 10).errorOffset() == 9);
+}
+
+static void testOnDemand()
+{
+    const std::string text {R"({"skip": {"a": [1, "]}", {"b": "\"}"}]}, "route": {"host": "example.org", "port": 8080,
+        "weights": [0.5, -2, true, null], "tags": []}, "route": false})"};
+    const JSONLazyValue document {text};
+    assert(document.type() == TokenType::DictOpen);
+    assert(document["\"route\""]["\"port\""].get<int64_t>() == 8080);
+    assert(document["\"route\""]["\"host\""].get<StringView>().value().equals("\"example.org\""));
+    assert(document["\"route\""]["\"weights\""][0].get<double>() == 0.5);
+    assert(document["\"route\""]["\"weights\""][1].get<int32_t>() == -2);
+    assert(document["\"route\""]["\"weights\""][2].get<bool>());
+    assert(document["\"route\""]["\"weights\""][3].type() == TokenType::Null);
+    assert(document["\"skip\""]["\"a\""][2]["\"b\""].raw().equals("\"\\\"}\""));
+    assert(document["\"skip\""].raw().size() == 30);
+    // the first entry with the name wins, wrong types give the default value
+    assert(document["\"route\""].type() == TokenType::DictOpen);
+    assert(document["\"route\""]["\"port\""].get<StringView>().value().size() == 0);
+
+    assert(!document["\"missing\""].valid());
+    assert(!document["\"missing\""]["\"port\""].valid());
+    assert(!document["\"route\""]["\"weights\""][4].valid());
+    assert(!document["\"route\""]["\"tags\""][0].valid());
+    assert(!document[0].valid());
+    assert(document["\"missing\""].get<int64_t>() == 0);
+
+    const std::string broken {"{\"a\": [1, 2, \"b\": 3}"};
+    assert(!JSONLazyValue(broken)["\"b\""].valid());
+    assert(!JSONLazyValue(broken)["\"a\""][3].valid());
+    assert(JSONLazyValue(broken)["\"a\""][1].get<int32_t>() == 2);
+    assert(!JSONLazyValue("  ", 2).valid());
+
+    // integers out of the range of the requested type give the default value instead of wrapping around
+    const std::string numberText {"[5000000000, 99999999999999999999, 18446744073709551615, -1, -2147483648]"};
+    const JSONLazyValue numbers {numberText};
+    assert(numbers[0].get<int32_t>() == 0 && numbers[0].get<int64_t>() == 5000000000 && numbers[0].get<uint64_t>() == 5000000000u);
+    assert(numbers[1].get<int64_t>() == 0 && numbers[1].get<uint64_t>() == 0u);
+    assert(numbers[2].get<int64_t>() == 0 && numbers[2].get<uint64_t>() == 18446744073709551615u);
+    assert(numbers[3].get<int32_t>() == -1 && numbers[3].get<uint64_t>() == 0u);
+    assert(numbers[4].get<int32_t>() == -2147483647 - 1);
+}
+
+static void testStructuralIndex()
+{
+    static_assert(classifyToken("\"a\\\"b\"", 6, 0).type == TokenType::String);
+    static_assert(classifyToken("\"a\\\"b\"", 6, 0).length == 6);
+
+    // strings with escapes, structural characters inside strings and tokens across 64 byte blocks
+    std::string text {"{\"key\": \"va\\\"l{ue],\\\\\", \"list\": [1, -2.5e3, true, null, false]"};
+    while (text.size() < 200) {
+        text += ", \"k" + std::to_string(text.size()) + "\": \"x\\\\\\\"\"";
+    }
+    text += ", \"tail\": 06, \"bad\": tru}";
+    JSONStructuralIndex index {text.data(), text.size()};
+    size_t pos {0};
+    while (true) {
+        const JSONToken token {index.next()};
+        pos = skipWhitespace(text.data(), text.size(), pos);
+        if (pos >= text.size()) {
+            assert(token.type == TokenType::Invalid && token.offset == text.size());
+            break;
+        }
+        const JSONToken expected {classifyToken(text.data(), text.size(), pos)};
+        assert(token.type == expected.type && token.offset == expected.offset && token.length == expected.length);
+        if (token.type == TokenType::Invalid) {
+            break;
+        }
+        pos += expected.length;
+    }
+    assert(JSONDocument(text).errorOffset() == text.find("06") + 1);
+
+    // an index reset to shorter input keeps its buffers but none of the previous positions
+    const std::string shorter {"[\"a\\\"\", 12]"};
+    index.reset(shorter.data(), shorter.size());
+    assert(index.size() == 6);
+    assert(index.next().type == TokenType::ArrayOpen);
+    assert(index.next().length == 5);
+    assert(index.next().type == TokenType::Comma);
+    assert(index.next().type == TokenType::Number);
+    assert(index.next().type == TokenType::ArrayClose);
+    assert(index.next().type == TokenType::Invalid);
+    JSONArena arena;
+    JSONKeyPool keys;
+    const JSONDocument first {text.data(), text.size(), arena, keys, index};
+    assert(!first.success() && first.errorOffset() == text.find("06") + 1);
+    const JSONDocument second {shorter.data(), shorter.size(), arena, keys, index};
+    assert(second.success() && second.root().size() == 2 && second.root()[1].as<int32_t>() == 12);
+}
+
+static void testStreamingReader()
+{
+    constexpr const char text[] = "{\"key\": \"va\\\"l{ue],\", \"list\": [1, -2.5e3, true, null, []], \"n\": {\"x\": 123456789}}";
+    const auto events = [&](size_t chunkSize, size_t bufferSize) {
+        JSONBufferSource source {text, sizeof(text) - 1, chunkSize};
+        JSONReader<JSONBufferSource> reader {source, bufferSize};
+        std::string result;
+        const bool success {reader.parse([&](const JSONEvent &event) {
+            result += std::to_string(static_cast<int>(event.type)) + event.text.toString() + std::to_string(event.offset);
+        })};
+        return success ? result : std::string();
+    };
+    // tokens split at every possible chunk boundary
+    const std::string expected {events(sizeof(text), 1024)};
+    assert(!expected.empty());
+    for (size_t chunkSize = 1; chunkSize < 8; ++chunkSize) {
+        assert(events(chunkSize, chunkSize) == expected);
+    }
+
+    JSONBufferSource source {text, sizeof(text) - 1, 3};
+    JSONReader<JSONBufferSource> reader {source, 4};
+    assert(reader.next().type == JSONEventType::StartObject);
+    const JSONEvent key {reader.next()};
+    assert(key.type == JSONEventType::Key && key.as<StringView>().value().equals("\"key\""));
+    assert(reader.next().type == JSONEventType::String);
+    reader.next();
+    reader.next();
+    assert(reader.next().as<int32_t>() == 1);
+    assert(reader.next().as<double>() == -2500.0);
+    assert(reader.next().as<bool>());
+
+    constexpr const char large[] = "[5000000000, 99999999999999999999, 18446744073709551615]";
+    JSONBufferSource largeSource {large, sizeof(large) - 1};
+    JSONReader<JSONBufferSource> largeReader {largeSource};
+    largeReader.next();
+    const JSONEvent int64Event {largeReader.next()};
+    assert(int64Event.as<int32_t>() == 0 && int64Event.as<int64_t>() == 5000000000);
+    const JSONEvent overflowEvent {largeReader.next()};
+    assert(overflowEvent.as<int64_t>() == 0 && overflowEvent.as<uint64_t>() == 0u);
+    const JSONEvent uint64Event {largeReader.next()};
+    assert(uint64Event.as<int64_t>() == 0 && uint64Event.as<uint64_t>() == 18446744073709551615u);
+
+    for (const char *malformed : { "{\"a\" 1}", "[1, ]", "{\"a\": 1} 2", "[", "", "{\"a\": tru}", "[1e]" }) {
+        JSONBufferSource malformedSource {malformed, std::strlen(malformed), 2};
+        JSONReader<JSONBufferSource> malformedReader {malformedSource, 2};
+        const bool success {malformedReader.parse([](const JSONEvent &) {})};
+        assert(!success);
+        assert(malformedReader.errorOffset() == JSONDocument(malformed, std::strlen(malformed)).errorOffset());
+    }
+
+    // memory stays at the chunk size for any number of records
+    std::string records {"["};
+    for (size_t i = 0; i < 10000; ++i) {
+        records += (i ? ", " : "") + std::string("{\"id\": ") + std::to_string(i) + "}";
+    }
+    std::istringstream stream {records + "]"};
+    JSONStreamSource streamSource {stream};
+    JSONReader<JSONStreamSource> streamReader {streamSource, 256};
+    int64_t sum {0};
+    const bool success {streamReader.parse([&](const JSONEvent &event) { sum += event.as<int64_t>(); })};
+    assert(success && sum == 49995000);
+    assert(streamReader.memoryUsage() == 256);
+
+    // NDJSON: one document per line, EndDocument only at the end of the input
+    const std::string ndjson {"{\"a\":1}\n{\"a\":2}\n[3, {\"a\": 4}]\n5\n\n"};
+    for (size_t chunkSize = 1; chunkSize < 8; ++chunkSize) {
+        JSONBufferSource linesSource {ndjson.data(), ndjson.size(), chunkSize};
+        JSONReader<JSONBufferSource> linesReader {linesSource, JSONReaderMode::MultipleDocuments, chunkSize};
+        int64_t linesSum {0};
+        size_t documents {0};
+        size_t depth {0};
+        const bool linesSuccess {linesReader.parse([&](const JSONEvent &event) {
+            linesSum += event.as<int64_t>();
+            depth += (event.type == JSONEventType::StartObject || event.type == JSONEventType::StartArray) ? 1 : 0;
+            depth -= (event.type == JSONEventType::EndObject || event.type == JSONEventType::EndArray) ? 1 : 0;
+            documents += (depth == 0) ? 1 : 0;
+        })};
+        assert(linesSuccess && linesSum == 15 && documents == 4);
+        const JSONEvent end {linesReader.next()};
+        assert(end.type == JSONEventType::EndDocument && end.offset == ndjson.size());
+    }
+    JSONBufferSource emptySource {"", 0};
+    assert(JSONReader<JSONBufferSource>(emptySource, JSONReaderMode::MultipleDocuments).next().type == JSONEventType::EndDocument);
+    const std::string brokenLines {"{\"a\":1}\n{\"a\":}\n"};
+    JSONBufferSource brokenSource {brokenLines.data(), brokenLines.size(), 3};
+    JSONReader<JSONBufferSource> brokenReader {brokenSource, JSONReaderMode::MultipleDocuments, 4};
+    assert(!brokenReader.parse([](const JSONEvent &) {}) && brokenReader.errorOffset() == 13);
+    JSONBufferSource unclosedSource {"{\"a\":1}\n[", 9};
+    assert(!JSONReader<JSONBufferSource>(unclosedSource, JSONReaderMode::MultipleDocuments).parse([](const JSONEvent &) {}));
+}
+
+static void testJSONLines()
+{
+    std::string lines;
+    for (size_t i = 0; i < 5000; ++i) {
+        lines += "{\"id\": " + std::to_string(i) + ", \"tags\": [\"a\", {\"b\": null}]}\n" + (i % 100 ? "" : " \r\n");
+    }
+    for (size_t threads = 1; threads <= 4; ++threads) {
+        std::atomic<int64_t> sum {0};
+        const JSONLinesResult result {parseJSONLines(lines.data(), lines.size(), threads, [&](const JSONNode &record, size_t) {
+            sum += record.get<int64_t>("\"id\"");
+        })};
+        assert(result.records == 5000 && result.errors == 0);
+        assert(sum == 12497500);
+    }
+
+    const std::string malformed {"[1]\n{\"a\": }\n\n[2, 3]\n[4,"};
+    size_t values {0};
+    const JSONLinesResult result {parseJSONLines(malformed.data(), malformed.size(), 1, [&](const JSONNode &record, size_t) {
+        values += record.size();
+    })};
+    assert(result.records == 2 && result.errors == 2 && values == 3);
+    assert(result.firstErrorOffset == malformed.find('}'));
+}
+
+static constexpr const char findTest_Periodic[] = "abaabaabaabbabaabaabaabaabb";
+static void testStringFind()
+{
+    using Periodic = String<findTest_Periodic, 0, sizeof(findTest_Periodic) - 1>;
+    static_assert(Periodic::find("abaabaabb") == 3);
+    static_assert(Periodic::find("abaabaabb", 4) == 18);
+    static_assert(Periodic::find("abaabaabbb") == std::string::npos);
+    static_assert(Periodic::find("bb") == 10);
+    static_assert(Periodic::find("") == 0);
+    static_assert(String<findTest_Periodic, 3, 9>::find("abaabaabb") == 0);
+    static_assert(String<findTest_Periodic, 3, 8>::find("abaabaabb") == std::string::npos);
+
+    constexpr StringView text {"aaaaaaaaaaaaaaab", 16};
+    static_assert(text.find("aaab") == 12);
+    static_assert(text.find("aaaa", 13) == std::string::npos);
+    static_assert(text.find('b') == 15);
+    static_assert(text.find('a', 16) == std::string::npos);
+    static_assert(text.find(StringView {"", 0}, 16) == 16);
+
+    // runtime uses memchr for single characters, both paths are compared with std::string_view on small alphabets
+    std::mt19937 random {42};
+    for (size_t i = 0; i < 20000; ++i) {
+        const char alphabet {static_cast<char>('a' + 1 + random() % 3)};
+        std::string haystack, needle;
+        for (size_t j = random() % 48; j > 0; --j) {
+            haystack += static_cast<char>('a' + random() % (alphabet - 'a'));
+        }
+        for (size_t j = random() % 9; j > 0; --j) {
+            needle += static_cast<char>('a' + random() % (alphabet - 'a'));
+        }
+        const size_t from {random() % (haystack.size() + 2)};
+        const StringView view {haystack.data(), haystack.size()};
+        assert(view.find(StringView {needle.data(), needle.size()}, from) == std::string_view(haystack).find(needle, from));
+        assert(view.find(alphabet - 1, from) == std::string_view(haystack).find(alphabet - 1, from));
+    }
+}
+
+static constexpr const char stringTest_Escapes[] = R"TAG({ "say" : "a \"quoted\" \u00e9\ud83d\ude00 word\\" })TAG";
+static void testStringEscapes()
+{
+    static_assert(scanString("\"a\\u00e9\"", 9, 0) == 9);
+    static_assert(scanString("\"\xc3\xa9\xf0\x9f\x98\x80\"", 8, 0) == 8);
+    static_assert(scanString("\"\\x\"", 4, 0) == 0);
+    static_assert(scanString("\"\x01\"", 3, 0) == 0);
+    static_assert(scanString("\"\xc3\"", 3, 0) == 0);
+    static_assert(scanString("\"\xc0\xaf\"", 4, 0) == 0);
+    static_assert(scanString("\"\xed\xa0\x80\"", 5, 0) == 0);
+    static_assert(scanString("\"\\uDC00\"", 8, 0) == 0);
+    static_assert(scanString("\"\\uD83D\\u0041\"", 14, 0) == 0);
+    static_assert(scanString("\"\\u12G4\"", 8, 0) == 0);
+
+    using Parser = JSONParser<String<stringTest_Escapes, 0, sizeof(stringTest_Escapes) - 1>>;
+    static_assert(Parser::success);
+    constexpr auto json_obj { JSONDeclarator<Parser::Result>::createObject() };
+    constexpr StringView say {json_obj.get<StringView>("\"say\"")};
+    static_assert(say.size() == 40);
+
+    constexpr auto decoded {[](const StringView &token) {
+        std::array<char, 32> result {};
+        unescapeString(token.data(), token.size(), result.data());
+        return result;
+    }(say)};
+    static_assert(unescapeString(say.data(), say.size(), nullptr) == 23);
+    static_assert(StringView(decoded.data(), 23).equals("a \"quoted\" \xc3\xa9\xf0\x9f\x98\x80 word\\"));
+
+    // long runs of plain characters take the SIMD path at runtime
+    std::string text {"[\"" + std::string(100, 'x') + "\\\"" + std::string(40, 'y') + "\xc3\xa9\", \"" + std::string(70, 'z') + "\"]"};
+    assert(JSONDocument(text).success());
+    assert(JSONDocument(text).root()[0].size() == 146);
+    for (const char *invalid : { "\x01", "\xff", "\\q", "\t" }) {
+        const std::string malformed {"[\"" + std::string(100, 'x') + invalid + "\"]"};
+        assert(!JSONDocument(malformed).success());
+        assert(JSONDocument(malformed).errorOffset() == 1);
+    }
+    // 0x1F is the last control character, behind the first 16 and 32 byte blocks
+    for (size_t position : { 16, 17, 31, 32, 40, 63, 100 }) {
+        std::string unit(120, 'x');
+        unit[position] = '\x1f';
+        const std::string quoted {"\"" + unit + "\""};
+        assert(scanString(quoted.data(), quoted.size(), 0) == 0);
+        assert(!isValidStringContent(unit.data(), unit.size()));
+        assert(!JSONDocument("[" + quoted + "]").success());
+        unit[position] = ' ';
+        assert(isValidStringContent(unit.data(), unit.size()));
+    }
+}
+
+struct BindingTest_Inner
+{
+    StringView name;
+    int32_t depth;
+};
+
+struct BindingTest_Outer
+{
+    int32_t id;
+    int64_t wideId;
+    double depth;
+    StringView name;
+};
+
+struct BindingTest_Record
+{
+    int32_t id;
+    BindingTest_Inner inner;
+    bool active;
+    double score;
+};
+
+namespace ctjson
+{
+    template <>
+    struct JSONBinding<BindingTest_Inner>
+    {
+        static constexpr auto fields {std::make_tuple(jsonField("\"name\"", &BindingTest_Inner::name), jsonField("\"depth\"", &BindingTest_Inner::depth))};
+    };
+
+    template <>
+    struct JSONBinding<BindingTest_Outer>
+    {
+        static constexpr auto fields {std::make_tuple(jsonField("\"id\"", &BindingTest_Outer::id), jsonField("\"id\"", &BindingTest_Outer::wideId),
+                                                      jsonField("\"depth\"", &BindingTest_Outer::depth), jsonField("\"name\"", &BindingTest_Outer::name))};
+    };
+
+    template <>
+    struct JSONBinding<BindingTest_Record>
+    {
+        static constexpr auto fields {std::make_tuple(jsonField("\"id\"", &BindingTest_Record::id), jsonField("\"inner\"", &BindingTest_Record::inner),
+                                                      jsonField("\"active\"", &BindingTest_Record::active), jsonField("\"score\"", &BindingTest_Record::score))};
+    };
+} // namespace ctjson
+
+static constexpr auto bindingTest_Object {JSONDeclarator<JSONParser<String<tokenTest_ObjectDef_lookup, 0, sizeof(tokenTest_ObjectDef_lookup) - 1>>::Result>::createObject()};
+static constexpr const char bindingTest_NestedOnly[] = R"({"name": "outer", "id": 7, "inner": {"depth": 2}})";
+static constexpr auto bindingTest_NestedOnlyObject {JSONDeclarator<JSONParser<JSONText<bindingTest_NestedOnly>>::Result>::createObject()};
+static void testBinding()
+{
+    // a field missing from the object or with a different type does not compile,
+    // only direct entries count, as for the runtime parser
+    constexpr BindingTest_Outer outer {bindJSON<BindingTest_Outer, bindingTest_Object>()};
+    static_assert(!priv::findEntry(bindingTest_NestedOnlyObject, "\"depth\"").found);
+    static_assert(priv::findEntry(bindingTest_NestedOnlyObject, "\"id\"").found);
+#if defined(CTJSON_EXPECT_COMPILE_ERROR)
+    // fails on "field is missing from the JSON object", "depth" is only in the nested object
+    constexpr BindingTest_Outer nestedOnly {bindJSON<BindingTest_Outer, bindingTest_NestedOnlyObject>()};
+#endif
+    static_assert(outer.id == 7);
+    static_assert(outer.wideId == 7);
+    static_assert(outer.depth == 1.0);
+    static_assert(outer.name.equals("\"outer\""));
+    static_assert(bindingTest_Object.get<int64_t>("\"id\"") == 7);
+    static_assert(bindingTest_Object.get<double>("\"id\"") == 7.0);
+    static_assert(bindingTest_Object.get<bool>("\"id\"") == false);
+
+    constexpr const char text[] = "{\"score\": 2.5, \"skip\": [{\"a\": [1, {}]}], \"inner\": {\"depth\": 3, \"name\": \"x\"}, \"active\": true, \"id\": -4, \"id\": 5}";
+    BindingTest_Record record {};
+    const JSONBindResult result {parseJSON(text, sizeof(text) - 1, record)};
+    assert(result.success);
+    assert(record.id == -4 && record.active && record.score == 2.5);
+    assert(record.inner.depth == 3 && record.inner.name.equals("\"x\""));
+
+    for (const char *malformed : { "{\"id\": 1, \"inner\": {\"depth\": 3, \"name\": \"x\"}, \"score\": 1}", "{\"id\": 1.5}", "{\"id\": 3000000000}", "{\"id\": 18446744073709551617}",
+                                   "{\"skip\": [}", "{\"id\": 1,}", "[]" }) {
+        assert(!parseJSON(malformed, std::strlen(malformed), record).success);
+    }
+    const char missing[] = "{\"id\": 1, \"inner\": {\"depth\": 3}}";
+    assert(parseJSON(missing, sizeof(missing) - 1, record).errorOffset == sizeof(missing) - 3);
+
+    // fields sharing a name are all filled from the first entry with it, at runtime as at compile time
+    constexpr const char outerText[] = "{\"name\": \"outer\", \"id\": 7, \"depth\": 2, \"id\": 8}";
+    BindingTest_Outer runtimeOuter {};
+    BindingTest_Outer lookupOuter {};
+    assert(parseJSON(tokenTest_ObjectDef_lookup, sizeof(tokenTest_ObjectDef_lookup) - 1, lookupOuter).success);
+    assert(lookupOuter.depth == outer.depth && lookupOuter.id == outer.id && lookupOuter.name.equals(outer.name));
+    assert(parseJSON(outerText, sizeof(outerText) - 1, runtimeOuter).success);
+    assert(runtimeOuter.id == 7 && runtimeOuter.wideId == 7 && runtimeOuter.depth == 2.0 && runtimeOuter.name.equals("\"outer\""));
+    constexpr const char wideText[] = "{\"name\": \"outer\", \"id\": 5000000000, \"depth\": 2}";
+    assert(parseJSON(wideText, sizeof(wideText) - 1, runtimeOuter).errorOffset == 24);
+}
+
+static constexpr const char serializerTest_Object[] = R"TAG(
+{
+    "name": "ctjson",
+    "version": 2,
+    "ratio": 0.1,
+    "matrix": [[1, 2], [3, 4]],
+    "nested": { "on": true, "scale": -2.5e-7 }
+}
+)TAG";
+static constexpr auto serializerTest_Tree {JSONDeclarator<JSONParser<String<serializerTest_Object, 0, sizeof(serializerTest_Object) - 1>>::Result>::createObject()};
+static constexpr BindingTest_Record serializerTest_Record {-4, {StringView("\"x\"", 3), 3}, true, 1e21};
+static void testSerializer()
+{
+    constexpr auto tree {serializeJSON<serializerTest_Tree>()};
+    constexpr const char treeText[] = "{\"name\":\"ctjson\",\"version\":2,\"ratio\":0.1,\"matrix\":[[1,2],[3,4]],\"nested\":{\"on\":true,\"scale\":-2.5e-07}}";
+    static_assert(tree.size() == sizeof(treeText));
+    static_assert(StringView(tree.data(), tree.size() - 1).equals(treeText));
+
+    constexpr auto record {serializeJSON<serializerTest_Record>()};
+    constexpr const char recordText[] = "{\"id\":-4,\"inner\":{\"name\":\"x\",\"depth\":3},\"active\":true,\"score\":1e+21}";
+    static_assert(StringView(record.data(), record.size() - 1).equals(recordText));
+
+    // runtime output is the same, a small buffer only receives what fits
+    char buffer[256] {};
+    assert(serializeJSON(serializerTest_Tree, buffer, sizeof(buffer)) == sizeof(treeText) - 1);
+    assert(std::memcmp(buffer, treeText, sizeof(treeText) - 1) == 0);
+    assert(serializeJSON(serializerTest_Record, buffer, 4) == sizeof(recordText) - 1);
+
+    static_assert(escapeString("a\"b\\c\n\x01", 7, nullptr) == 15);
+    const char text[] = "quote \" backslash \\ tab \t bell \x07 unicode \xC3\xA9, long enough for a SIMD block";
+    JSONWriter writer {buffer, sizeof(buffer)};
+    writer.startObject();
+    writer.key("text", 4);
+    writer.string(text, sizeof(text) - 1);
+    writer.key("values", 6);
+    writer.startArray();
+    writer.value(1.5);
+    writer.value(int64_t {-9007199254740993});
+    writer.null();
+    writer.value(serializerTest_Tree.get<std::array<std::array<int32_t, 2>, 2>>("\"matrix\"").value());
+    writer.endArray();
+    writer.endObject();
+    const char expected[] = "{\"text\":\"quote \\\" backslash \\\\ tab \\t bell \\u0007 unicode \xC3\xA9, long enough for a SIMD block\","
+                            "\"values\":[1.5,-9007199254740993,null,[[1,2],[3,4]]]}";
+    assert(!writer.overflow() && writer.size() == sizeof(expected) - 1);
+    assert(std::memcmp(buffer, expected, sizeof(expected) - 1) == 0);
+
+    // shortest round trip formatting, the constexpr implementation matches std::to_chars
+    static_assert(serializeJSON(0.3, nullptr, 0) == 3);
+    std::mt19937_64 random {7};
+    for (size_t i = 0; i < 10000; ++i) {
+        const uint64_t bits {random()};
+        double value {0.0};
+        std::memcpy(&value, &bits, sizeof(value));
+        if (value - value != 0) {
+            continue;
+        }
+        char expectedDigits[maxNumberLength] {};
+        char digits[maxNumberLength] {};
+        const size_t length {static_cast<size_t>(std::to_chars(expectedDigits, expectedDigits + maxNumberLength, value).ptr - expectedDigits)};
+        assert(formatDouble(value, digits) == length && std::memcmp(digits, expectedDigits, length) == 0);
+    }
+}
+
+static constexpr const char pointerTest_Object[] = R"TAG(
+{
+    "servers": [{ "host": "alpha", "port": 80 }, { "host": "beta", "port": 8080 }],
+    "a/b": 1,
+    "m~n": 2,
+    "esc\u0041": 3,
+    "matrix": [[1, 2], [3, 4]]
+}
+)TAG";
+static constexpr auto pointerTest_Tree {JSONDeclarator<JSONParser<String<pointerTest_Object, 0, sizeof(pointerTest_Object) - 1>>::Result>::createObject()};
+static constexpr const char pointerTest_Port[] = "/servers/1/port";
+static constexpr const char pointerTest_Host[] = "/servers/0/host";
+static constexpr const char pointerTest_Slash[] = "/a~1b";
+static constexpr const char pointerTest_Tilde[] = "/m~0n";
+static constexpr const char pointerTest_Escaped[] = "/escA";
+static constexpr const char pointerTest_Matrix[] = "/matrix/1/0";
+static constexpr const char pointerTest_Row[] = "/matrix/1";
+static constexpr const char pointerTest_Root[] = "";
+static constexpr const char pointerTest_OutOfRange[] = "/servers/2";
+static constexpr const char pointerTest_LeadingZero[] = "/matrix/01";
+static constexpr const char pointerTest_Missing[] = "/servers/0/user";
+static constexpr const char pointerTest_TooDeep[] = "/a~1b/0";
+static constexpr const char pointerTest_NoSlash[] = "servers";
+static void testJSONPointer()
+{
+    static_assert(at<pointerTest_Port, pointerTest_Tree>() == 8080);
+    static_assert(at<pointerTest_Host, pointerTest_Tree>().equals("\"alpha\""));
+    static_assert(at<pointerTest_Slash, pointerTest_Tree>() == 1);
+    static_assert(at<pointerTest_Tilde, pointerTest_Tree>() == 2);
+    static_assert(at<pointerTest_Escaped, pointerTest_Tree>() == 3);
+    static_assert(at<pointerTest_Matrix, pointerTest_Tree>() == 3);
+    static_assert(std::is_same_v<decltype(at<pointerTest_Row, pointerTest_Tree>()), const std::array<int32_t, 2> &>);
+    static_assert(&at<pointerTest_Root, pointerTest_Tree>() == &pointerTest_Tree);
+
+    static_assert(!containsPointer<pointerTest_OutOfRange, pointerTest_Tree>);
+    static_assert(!containsPointer<pointerTest_LeadingZero, pointerTest_Tree>);
+    static_assert(!containsPointer<pointerTest_Missing, pointerTest_Tree>);
+    static_assert(!containsPointer<pointerTest_TooDeep, pointerTest_Tree>);
+    static_assert(!containsPointer<pointerTest_NoSlash, pointerTest_Tree>);
+
+    // a plain reference into the tree, usable at runtime like any other constant
+    const int32_t &port {at<pointerTest_Port, pointerTest_Tree>()};
+    assert(port == 8080);
+}
+
+static constexpr const char schemaTest_Schema[] = R"({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "type": "object",
+    "required": ["host", "port"],
+    "properties": {
+        "host": {"type": "string"},
+        "port": {"type": "integer", "minimum": 1, "maximum": 65535},
+        "mode": {"enum": ["fast", "safe", 3, null]},
+        "weights": {"type": "array", "items": {"type": ["number", "null"], "minimum": 0}},
+        "a/b~": {"type": "boolean"}
+    }
+})";
+static constexpr auto schemaTest_Compiled {compileSchema<schemaTest_Schema>()};
+static constexpr const char schemaTest_Valid[] = R"({"host": "example.org", "port": 8080, "mode": 3.0, "weights": [0.5, null, 2], "extra": {"x": [1]}})";
+static constexpr const char schemaTest_Invalid[] = R"({"host": "example.org", "port": 8080, "weights": [0.5, -1]})";
+
+static void testSchema()
+{
+    static_assert(checkSchema<schemaTest_Compiled, schemaTest_Valid>());
+    // static_assert(checkSchema<schemaTest_Compiled, schemaTest_Invalid>()) fails on JSONSchemaViolation<Minimum, 55, '/', 'w', ... '1'>
+    constexpr JSONValidationResult invalid {validateJSON(schemaTest_Compiled, schemaTest_Invalid, sizeof(schemaTest_Invalid) - 1)};
+    static_assert(invalid.error == JSONValidationError::Minimum && invalid.offset == 55);
+    static_assert(StringView(invalid.path, invalid.pathLength).equals("/weights/1"));
+
+    constexpr const char unsupported[] = "{\"type\": \"object\", \"minLength\": 2}";
+    static_assert(!priv::compileSchemaText<16>(unsupported, sizeof(unsupported) - 1).valid);
+    static_assert(priv::compileSchemaText<16>(unsupported, sizeof(unsupported) - 1).errorOffset == 19);
+    constexpr const char emptyEnum[] = "{\"enum\": []}";
+    static_assert(!priv::compileSchemaText<8>(emptyEnum, sizeof(emptyEnum) - 1).valid);
+
+    // the same tables validate at runtime
+    const struct {
+        const char *document;
+        JSONValidationError error;
+        size_t offset;
+        const char *path;
+    } cases[] {
+        { "{\"host\": \"h\", \"port\": 0}", JSONValidationError::Minimum, 22, "/port" },
+        { "{\"host\": \"h\", \"port\": 65536}", JSONValidationError::Maximum, 22, "/port" },
+        { "{\"host\": \"h\", \"port\": 9223372036854775808}", JSONValidationError::Maximum, 22, "/port" },
+        { "{\"host\": \"h\", \"port\": 18446744073709551616}", JSONValidationError::Maximum, 22, "/port" },
+        { "{\"host\": \"h\", \"port\": -9223372036854775809}", JSONValidationError::Minimum, 22, "/port" },
+        { "{\"host\": \"h\", \"port\": 1, \"weights\": [9223372036854775808]}", JSONValidationError::None, 0, "" },
+        { "{\"host\": \"h\", \"port\": 1, \"weights\": [-9223372036854775809]}", JSONValidationError::Minimum, 37, "/weights/0" },
+        { "{\"host\": \"h\"}", JSONValidationError::Required, 0, "/port" },
+        { "{\"host\": \"h\", \"port\": 1, \"a/b~\": 1}", JSONValidationError::Type, 33, "/a~1b~0" },
+        { "{\"host\": \"h\", \"port\": 1, \"mode\": \"slow\"}", JSONValidationError::Enum, 33, "/mode" },
+        { "{\"host\": \"h\", \"port\": 1.5}", JSONValidationError::Type, 22, "/port" },
+        { "{\"host\": \"h\", \"port\": 1, \"weights\": [1, \"x\"]}", JSONValidationError::Type, 40, "/weights/1" },
+        { "{\"host\": \"h\", \"port\": 1,}", JSONValidationError::Syntax, 24, "" },
+        { "{\"host\": \"h\", \"port\": 1} x", JSONValidationError::Syntax, 25, "" },
+        { "[1]", JSONValidationError::Type, 0, "" },
+        { "{\"host\": \"h\", \"port\": 1, \"mode\": null}", JSONValidationError::None, 0, "" },
+    };
+    for (const auto &check : cases) {
+        const JSONValidationResult result {validateJSON(schemaTest_Compiled, check.document, std::strlen(check.document))};
+        assert(result.error == check.error && result.offset == check.offset);
+        assert(std::string(result.path, result.pathLength) == check.path);
+    }
+    const std::string deep(1000, '[');
+    assert(validateJSON(schemaTest_Compiled, deep.data(), deep.size()).error == JSONValidationError::Type);
+    const std::string nested {"{\"host\": \"h\", \"port\": 1, \"x\": " + deep + "}"};
+    assert(validateJSON(schemaTest_Compiled, nested.data(), nested.size()).error == JSONValidationError::Depth);
+}
+
+static constexpr const char mergeTest_Base[] = R"({
+    "server": {"host": "localhost", "port": 8080, "tls": {"enabled": false}},
+    "log": "debug",
+    "features": ["a", "b"]
+})";
+static constexpr const char mergeTest_Production[] = R"({"server": {"host": "example.org", "tls": {"enabled": true}}, "log": null, "features": ["a"]})";
+static constexpr const char mergeTest_Local[] = R"({"server": {"port": 9090}})";
+using MergeTest_Production = JSONMergePatch<mergeTest_Base, mergeTest_Production>;
+using MergeTest_Layered = JSONMergePatch<MergeTest_Production::text, mergeTest_Local>;
+static constexpr auto mergeTest_Tree {JSONDeclarator<JSONParser<MergeTest_Layered::Input>::Result>::createObject()};
+static constexpr const char mergeTest_Port[] = "/server/port";
+static constexpr const char mergeTest_Host[] = "/server/host";
+
+static void testMergePatch()
+{
+    static_assert(StringView(MergeTest_Production::text, sizeof(MergeTest_Production::text) - 1).equals(
+        R"({"server":{"host":"example.org","port":8080,"tls":{"enabled":true}},"features":["a"]})"));
+    static_assert(at<mergeTest_Port, mergeTest_Tree>() == 9090);
+    static_assert(at<mergeTest_Host, mergeTest_Tree>().equals("\"example.org\""));
+    constexpr const char broken[] = "{\"a\": 1";
+    static_assert(mergePatchJSON(broken, sizeof(broken) - 1, "{}", 2, nullptr, 0) == 0);
+
+    // examples of RFC 7386, appendix A
+    const struct {
+        const char *target;
+        const char *patch;
+        const char *result;
+    } cases[] {
+        { R"({"a":"b"})", R"({"a":"c"})", R"({"a":"c"})" },
+        { R"({"a":"b"})", R"({"b":"c"})", R"({"a":"b","b":"c"})" },
+        { R"({"a":"b"})", R"({"a":null})", R"({})" },
+        { R"({"a":"b","b":"c"})", R"({"a":null})", R"({"b":"c"})" },
+        { R"({"a":["b"]})", R"({"a":"c"})", R"({"a":"c"})" },
+        { R"({"a":"c"})", R"({"a":["b"]})", R"({"a":["b"]})" },
+        { R"({"a":{"b":"c"}})", R"({"a":{"b":"d","c":null}})", R"({"a":{"b":"d"}})" },
+        { R"({"a":[{"b":"c"}]})", R"({"a":[1]})", R"({"a":[1]})" },
+        { R"(["a","b"])", R"(["c","d"])", R"(["c","d"])" },
+        { R"({"a":"b"})", R"(["c"])", R"(["c"])" },
+        { R"({"a":"foo"})", "null", "null" },
+        { R"({"a":"foo"})", R"("bar")", R"("bar")" },
+        { R"({"e":null})", R"({"a":1})", R"({"e":null,"a":1})" },
+        { R"([1,2])", R"({"a":"b","c":null})", R"({"a":"b"})" },
+        { "{}", R"({"a":{"bb":{"ccc":null}}})", R"({"a":{"bb":{}}})" },
+    };
+    char buffer[64] {};
+    for (const auto &check : cases) {
+        const size_t length {mergePatchJSON(check.target, std::strlen(check.target), check.patch, std::strlen(check.patch), buffer, sizeof(buffer))};
+        assert(std::string(buffer, length) == check.result);
+    }
+    // a buffer which is too small gets the length of the whole result
+    assert(mergePatchJSON("{\"a\": 1}", 8, "{\"b\": 2}", 8, buffer, 4) == 13);
+}
+
+static constexpr const char flatTest_Config[] = R"({
+    "features": {"search": true, "beta": false, "limits": {"rate": 100, "burst": 2.5}},
+    "servers": [{"host": "a"}, {"host": "b"}],
+    "matrix": [[1, 2], [3, 4]],
+    "empty": [],
+    "name": "config",
+    "name": "duplicate"
+})";
+static constexpr auto flatTest_Tree {JSONDeclarator<JSONParser<JSONText<flatTest_Config>>::Result>::createObject()};
+using FlatTest_Table = JSONFlatTable<flatTest_Tree>;
+static void testFlatTable()
+{
+    static_assert(FlatTest_Table::count == 12);
+    static_assert(FlatTest_Table::entries[0].path.equals("features.beta"));
+    static_assert(FlatTest_Table::entries[FlatTest_Table::count - 1].path.equals("servers.1.host"));
+    static_assert(FlatTest_Table::get<bool>("features.search"));
+    static_assert(FlatTest_Table::get<int32_t>("features.limits.rate") == 100);
+    static_assert(FlatTest_Table::get<double>("features.limits.burst") == 2.5);
+    static_assert(FlatTest_Table::get<StringView>("servers.1.host").value().equals("\"b\""));
+    static_assert(FlatTest_Table::get<int32_t>("matrix.1.0") == 3);
+    static_assert(FlatTest_Table::get<StringView>("name").value().equals("\"config\""));
+    static_assert(FlatTest_Table::find("features") == nullptr && FlatTest_Table::find("empty") == nullptr);
+    static_assert(FlatTest_Table::index.valid());
+
+    // the table is sorted, so all paths below an object are one range
+    constexpr size_t first {FlatTest_Table::lowerBound(StringView("features.", 9))};
+    constexpr size_t last {FlatTest_Table::lowerBound(StringView("features/", 9))};
+    static_assert(last - first == 4);
+    for (size_t i = 1; i < FlatTest_Table::count; ++i) {
+        assert(!priv::pathLess(FlatTest_Table::entries[i].path, FlatTest_Table::entries[i - 1].path));
+    }
+
+    // lookups with runtime paths, as on a request path
+    const std::vector<std::string> paths {"features.beta", "matrix.0.1", "servers.0.host", "missing"};
+    assert(!FlatTest_Table::find(StringView(paths[0].data(), paths[0].size()))->value.as<bool>());
+    assert(FlatTest_Table::find(StringView(paths[1].data(), paths[1].size()))->value.as<int32_t>() == 2);
+    assert(FlatTest_Table::find(StringView(paths[2].data(), paths[2].size()))->value.as<StringView>().value().equals("\"a\""));
+    assert(FlatTest_Table::find(StringView(paths[3].data(), paths[3].size())) == nullptr);
+}
+
 static void testTypeList()
 {
     using I0 = EmptyTypeList;
@@ -264,6 +1275,13 @@ static void testTypeList()
     static_assert(std::is_same_v<I3_append::At<2>, float>);
     static_assert(std::is_same_v<I3_append::At<3>, bool>);
     static_assert(std::is_same_v<I3_append::At<4>, std::false_type>);
+
+    using I16 = TypeList<char, short, int, long, char, short, int, long, char, short, int, long, float, double, bool, std::string>;
+    static_assert(I16::length == 16);
+    static_assert(std::is_same_v<I16::At<12>, float>);
+    static_assert(std::is_same_v<I16::At<15>, std::string>);
+    static_assert(std::is_same_v<I16::At<16>, std::false_type>);
+    static_assert(std::is_same_v<I16::Append<void>::At<16>, void>);
 }
 
 static constexpr const char address_json[] = R"TAG(
@@ -276,6 +1294,19 @@ static constexpr const char address_json[] = R"TAG(
   }
 }
 )TAG";
+// as written by embed_json.sh, or by #embed without the terminating '\0'
+static constexpr const char embedTest_Terminated[] = {'{', '"', 'a', '"', ':', ' ', '[', '1', ',', ' ', '2', ']', '}', '\n', 0};
+static constexpr const char embedTest_Unterminated[] = {'[', '3', ',', ' ', '4', ']'};
+static void testEmbeddedText()
+{
+    static_assert(JSONText<embedTest_Terminated>::size() == sizeof(embedTest_Terminated) - 1);
+    static_assert(JSONText<embedTest_Unterminated>::size() == sizeof(embedTest_Unterminated));
+    constexpr auto terminated {JSONDeclarator<JSONParser<JSONText<embedTest_Terminated>>::Result>::createObject()};
+    constexpr auto unterminated {JSONDeclarator<JSONParser<JSONText<embedTest_Unterminated>>::Result>::createObject()};
+    static_assert(terminated.value()[1] == 2);
+    static_assert(unterminated[0] == 3 && unterminated[1] == 4);
+}
+
 static void testTokenizeAddress()
 {
 	using Input = String<address_json, 0, sizeof(address_json) - 1>;
@@ -342,12 +1373,32 @@ int main()
     testJSONNVParser();
     testTokenizerIterations();
     testTokenizer();
+    testTokenArray();
     testTypeList();
     testIntArrayParse();
     testStringArrayParse();
     testObjectParse();
     testObjectParseTwo();
     testObjectParseValueArray();
+    testNestedArrays();
+    testNumberTokens();
+    testWideIntegers();
+    testObjectParseNumbers();
+    testDictKeyIndex();
+    testRuntimeDocument();
+    testOnDemand();
+    testStructuralIndex();
+    testStringFind();
+    testStringEscapes();
+    testStreamingReader();
+    testJSONLines();
+    testBinding();
+    testSerializer();
+    testJSONPointer();
+    testSchema();
+    testMergePatch();
+    testFlatTable();
+    testEmbeddedText();
     testArrayParse_SyntaxError_0();
 	testTokenizeAddress();
 	testParseAddress();
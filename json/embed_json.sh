@@ -0,0 +1,37 @@
+#!/bin/bash
+# Generates a header holding a JSON file as a '\0' terminated constexpr char array, for parsing it at compile time:
+#   #include "config.h"
+#   using Parser = ctjson::JSONParser<ctjson::JSONText<config>>;
+# The bytes are written as integer literals, so the file may hold any text, including sequences which would end a raw string.
+# Build systems regenerate the header when the JSON file changes, e.g. with make:
+#   config.h: config.json ; ./embed_json.sh $< config $@
+# usage: ./embed_json.sh input.json name [output.h]
+if [[ $# -lt 2 || $# -gt 3 ]]; then
+	echo "usage: $0 input.json name [output.h]" >&2
+	exit 1
+fi
+INPUT=$1
+NAME=$2
+OUTPUT=${3:-/dev/stdout}
+if [[ ! "$NAME" =~ ^[A-Za-z_][A-Za-z0-9_]*$ ]]; then
+	echo "$NAME is not a C++ identifier" >&2
+	exit 1
+fi
+if [[ ! -r "$INPUT" ]]; then
+	echo "can not read $INPUT" >&2
+	exit 1
+fi
+{
+	echo "#pragma once"
+	echo "// generated by embed_json.sh from $(basename "$INPUT"), do not edit"
+	echo "inline constexpr const char $NAME[] = {"
+	# sixteen bytes per line, the terminating '\0' closes the list;
+	# bytes above 127 are character literals, as integers they would narrow where char is signed
+	od -An -v -tu1 "$INPUT" | awk '{
+		line = ""
+		for (i = 1; i <= NF; ++i)
+			line = line ($i > 127 ? sprintf("'"'"'\\x%02x'"'"'", $i) : $i) ","
+		print line
+	}'
+	echo "0};"
+} > "$OUTPUT"
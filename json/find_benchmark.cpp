@@ -0,0 +1,104 @@
+#include "StringUtils.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+    Substring search of StringView::find (two-way with a Horspool shift, memchr for single characters)
+    against the naive double loop it replaced and std::string_view::find.
+    Inputs: text with a rare needle, an adversarial "aa...ab" needle in a run of 'a', and a single character.
+    Results are printed to stdout as a JSON array.
+    usage: find_benchmark [haystack_bytes]
+*/
+
+namespace {
+
+using namespace ctjson;
+
+struct result {
+    const char* input;
+    const char* method;
+    size_t bytes;
+    size_t iterations;
+    double seconds;
+};
+
+// the search String::find used before
+static size_t naive_find(const char* haystack, size_t length, const char* needle, size_t needle_length)
+{
+    for (size_t i = 0; i + needle_length <= length; ++i) {
+        size_t j = 0;
+        while (j < needle_length && haystack[i + j] == needle[j])
+            ++j;
+        if (j == needle_length)
+            return i;
+    }
+    return std::string::npos;
+}
+
+// prevents the compiler from removing the benchmarked code
+static volatile size_t sink;
+
+template <typename Search>
+static result measure(const char* input, const char* method, size_t bytes, Search&& search)
+{
+    using clock = std::chrono::steady_clock;
+    constexpr double min_seconds = 0.2;
+    size_t iterations = 0;
+    double seconds = 0.0;
+    const auto start = clock::now();
+    do {
+        sink = search();
+        ++iterations;
+        seconds = std::chrono::duration<double>(clock::now() - start).count();
+    } while (seconds < min_seconds);
+    return result{input, method, bytes, iterations, seconds};
+}
+
+static void run(std::vector<result>& results, const char* input, const std::string& haystack, const std::string& needle)
+{
+    const StringView view(haystack.data(), haystack.size());
+    const StringView pattern(needle.data(), needle.size());
+    results.push_back(measure(input, "naive", haystack.size(), [&] {
+        return naive_find(haystack.data(), haystack.size(), needle.data(), needle.size());
+    }));
+    results.push_back(measure(input, "ctjson", haystack.size(), [&] { return view.find(pattern); }));
+    results.push_back(measure(input, "std", haystack.size(), [&] { return std::string_view(haystack).find(needle); }));
+    std::cerr << "done: " << input << '\n';
+}
+
+static void print(std::ostream& out, const result& r, bool last)
+{
+    const double total_bytes = static_cast<double>(r.bytes) * static_cast<double>(r.iterations);
+    out << "  {\"input\": \"" << r.input << "\", \"method\": \"" << r.method << "\", \"bytes\": " << r.bytes
+        << ", \"iterations\": " << r.iterations << ", \"seconds\": " << r.seconds
+        << ", \"mb_per_s\": " << total_bytes / r.seconds / 1e6 << '}' << (last ? "\n" : ",\n");
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    size_t size = 1024 * 1024;
+    if (argc > 1)
+        size = std::stoul(argv[1]);
+
+    std::string text;
+    for (size_t i = 0; text.size() < size; ++i)
+        text += "{\"id\": " + std::to_string(i) + ", \"name\": \"lorem ipsum dolor sit amet\", \"active\": true}, ";
+    std::string run_of_a(size, 'a');
+
+    std::vector<result> results;
+    run(results, "text", text, "\"name\": \"consectetur\"");
+    run(results, "adversarial", run_of_a, std::string(64, 'a') + 'b');
+    run(results, "character", text, "~");
+
+    std::cout << "[\n";
+    for (size_t i = 0; i < results.size(); ++i)
+        print(std::cout, results[i], i + 1 == results.size());
+    std::cout << "]\n";
+    return 0;
+}
@@ -0,0 +1,38 @@
+#!/bin/bash
+# builds and runs the substring search benchmark, JSON results are written to find_benchmark.json
+# the compile time of String::find on an adversarial constexpr input is printed to stderr,
+# next to the naive double loop it replaced
+# usage: find_benchmark.sh [haystack_bytes]
+g++ -O2 ${CXXFLAGS:--march=native} -std=c++17 -I. find_benchmark.cpp -Wall -o find_benchmark
+if [[ $? -ne 0 ]]; then
+	echo "g++ build failed!"
+	exit 1
+fi
+./find_benchmark "$@" > find_benchmark.json
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+{
+	echo '#include "StringUtils.h"'
+	echo "static constexpr const char haystack[] = \"$(head -c 20000 /dev/zero | tr '\0' a)\";"
+	echo "static constexpr const char needle[] = \"$(head -c 200 /dev/zero | tr '\0' a)b\";"
+	echo 'constexpr size_t naiveFind() {'
+	echo '    for (size_t i = 0; i + sizeof(needle) <= sizeof(haystack); ++i) {'
+	echo '        size_t j = 0;'
+	echo '        while (j + 1 < sizeof(needle) && haystack[i + j] == needle[j]) ++j;'
+	echo '        if (j + 1 == sizeof(needle)) return i;'
+	echo '    }'
+	echo '    return std::string::npos;'
+	echo '}'
+	echo '#if defined(NAIVE)'
+	echo 'static_assert(naiveFind() == std::string::npos);'
+	echo '#else'
+	echo 'static_assert(ctjson::String<haystack, 0, sizeof(haystack) - 1>::find(needle) == std::string::npos);'
+	echo '#endif'
+} > "$WORK_DIR/find.cpp"
+for variant in NAIVE TWO_WAY; do
+	start=$(date +%s.%N)
+	g++ -std=c++17 -fsyntax-only -fconstexpr-ops-limit=4000000000 -I. -D$variant "$WORK_DIR/find.cpp"
+	end=$(date +%s.%N)
+	awk -v s="$start" -v e="$end" -v v="$variant" 'BEGIN { printf "compile time %s: %.2f s\n", v, e - s }' >&2
+done
@@ -0,0 +1,107 @@
+#include "JSONLines.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+    Scaling of parseJSONLines with the number of threads, from 1 up to max_threads in powers of two.
+    Parses the given NDJSON file through a memory mapping, or a generated log-like document.
+    Results are printed to stdout as a JSON array.
+    usage: lines_benchmark [max_threads [file]]
+*/
+
+namespace {
+
+using namespace ctjson;
+
+struct result {
+    size_t threads;
+    size_t bytes;
+    size_t records;
+    size_t iterations;
+    double seconds;
+};
+
+static std::string generate_lines(size_t size)
+{
+    std::string out;
+    for (size_t i = 0; out.size() < size; ++i) {
+        const std::string id = std::to_string(i);
+        out += "{\"ts\": " + id + ", \"level\": \"info\", \"msg\": \"request " + id + " served\", \"latency\": "
+            + id + ".5e-3, \"ok\": " + (i % 7 ? "true" : "false") + ", \"tags\": [\"web\", \"eu\"]}\n";
+    }
+    return out;
+}
+
+// prevents the compiler from removing the benchmarked code
+static volatile size_t sink;
+
+static result measure(const char* data, size_t size, size_t threads)
+{
+    using clock = std::chrono::steady_clock;
+    constexpr double min_seconds = 0.5;
+    size_t iterations = 0;
+    size_t records = 0;
+    double seconds = 0.0;
+    const auto start = clock::now();
+    do {
+        std::atomic<size_t> values {0};
+        records = parseJSONLines(data, size, threads, [&](const JSONNode& record, size_t) {
+            values.fetch_add(record.size(), std::memory_order_relaxed);
+        }).records;
+        sink = values.load();
+        ++iterations;
+        seconds = std::chrono::duration<double>(clock::now() - start).count();
+    } while (seconds < min_seconds);
+    return result{threads, size, records, iterations, seconds};
+}
+
+static void print(std::ostream& out, const result& r, bool last)
+{
+    const double total_bytes = static_cast<double>(r.bytes) * static_cast<double>(r.iterations);
+    out << "  {\"threads\": " << r.threads << ", \"bytes\": " << r.bytes << ", \"records\": " << r.records
+        << ", \"iterations\": " << r.iterations << ", \"seconds\": " << r.seconds
+        << ", \"mb_per_s\": " << total_bytes / r.seconds / 1e6 << '}' << (last ? "\n" : ",\n");
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_threads = 32;
+    if (argc > 1)
+        max_threads = std::stoul(argv[1]);
+
+    std::string generated;
+    const char* data = nullptr;
+    size_t size = 0;
+    std::unique_ptr<JSONMappedFile> file;
+    if (argc > 2) {
+        file.reset(new JSONMappedFile(argv[2]));
+        if (!file->valid()) {
+            std::cerr << "cannot map " << argv[2] << '\n';
+            return 1;
+        }
+        data = file->data();
+        size = file->size();
+    } else {
+        generated = generate_lines(64 * 1024 * 1024);
+        data = generated.data();
+        size = generated.size();
+    }
+
+    std::vector<result> results;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        results.push_back(measure(data, size, threads));
+        std::cerr << "done: " << threads << " threads\n";
+    }
+
+    std::cout << "[\n";
+    for (size_t i = 0; i < results.size(); ++i)
+        print(std::cout, results[i], i + 1 == results.size());
+    std::cout << "]\n";
+    return 0;
+}
@@ -0,0 +1,9 @@
+#!/bin/bash
+# builds and runs the NDJSON thread scaling benchmark, JSON results are written to lines_benchmark.json
+# usage: lines_benchmark.sh [max_threads [file]]
+g++ -O2 ${CXXFLAGS:--march=native} -std=c++17 -pthread -I. lines_benchmark.cpp -Wall -o lines_benchmark
+if [[ $? -ne 0 ]]; then
+	echo "g++ build failed!"
+	exit 1
+fi
+./lines_benchmark "$@" > lines_benchmark.json
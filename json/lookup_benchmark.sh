@@ -0,0 +1,61 @@
+#!/bin/bash
+# Compile time cost of JSONDict lookups on flat objects of 10, 100 and 1000 keys.
+# The objects are declared from generated entry lists, so the parser does not dominate the timings.
+# "declare" only creates the object, "hashed" adds a get<> of every key through the key index,
+# "linear" does the same lookups by walking the entry chain.
+# usage: ./lookup_benchmark.sh [compiler]
+CXX=${1:-g++}
+TIMEOUT=${TIMEOUT:-300}
+SRC_DIR=$(cd "$(dirname "$0")" && pwd)
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+compile() {
+	local start end
+	start=$(date +%s.%N)
+	timeout "$TIMEOUT" "$CXX" -std=c++17 -fsyntax-only -ftemplate-depth=100000 -fconstexpr-depth=100000 \
+		-fconstexpr-ops-limit=4000000000 -I"$SRC_DIR" "$@" > /dev/null 2>&1
+	local status=$?
+	end=$(date +%s.%N)
+	if [[ $status -eq 124 ]]; then
+		echo "timeout"
+	elif [[ $status -ne 0 ]]; then
+		echo "failed"
+	else
+		awk -v s="$start" -v e="$end" 'BEGIN { printf "%.2f\n", e - s }'
+	fi
+}
+
+generate() {
+	local keys=$1
+	echo '#include "CTJson.h"'
+	echo 'using namespace ctjson;'
+	for ((i = 0; i < keys; ++i)); do
+		echo "static constexpr const char key$i[] = \"\\\"key$i\\\"\";"
+	done
+	echo 'using Entries = TypeList<'
+	for ((i = 0; i < keys; ++i)); do
+		echo "    $([[ $i -ne 0 ]] && echo ',')JSONNameValue<String<key$i, 0, sizeof(key$i) - 1>, JSONBaseValue<TokenType::String, String<key$i, 0, sizeof(key$i) - 1>>, TokenType::String>"
+	done
+	echo '>;'
+	echo 'constexpr auto object { JSONDeclarator<Entries>::createObject() };'
+	echo '#if defined(HASHED)'
+	echo '#define LOOKUP(key) static_assert(object.get<StringView>(key).value().equals(key))'
+	echo '#elif defined(LINEAR)'
+	echo '#define LOOKUP(key) static_assert(object.entries().get<StringView>(key).value().equals(key))'
+	echo '#else'
+	echo '#define LOOKUP(key)'
+	echo '#endif'
+	for ((i = 0; i < keys; ++i)); do
+		echo "LOOKUP(\"\\\"key$i\\\"\");"
+	done
+}
+
+echo "keys,mode,seconds"
+for keys in 10 100 1000; do
+	source_file="$WORK_DIR/dict_$keys.cpp"
+	generate "$keys" > "$source_file"
+	echo "$keys,declare,$(compile "$source_file")"
+	echo "$keys,hashed,$(compile -DHASHED "$source_file")"
+	echo "$keys,linear,$(compile -DLINEAR "$source_file")"
+done
@@ -0,0 +1,237 @@
+#include "JSONDocument.h"
+#include "JSONOnDemand.h"
+#include "JSONSchema.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+    Runtime parsing throughput of JSONDocument, compared with a DOM which allocates every
+    string, array and object separately (the layout used by nlohmann::json).
+    Both parsers use the ctjson tokenizer, "structural_index" measures the SIMD indexing stage alone.
+    "schema_validation" checks the document against a compiled JSON schema without building a DOM.
+    "on_demand" reads three fields of the last record with JSONLazyValue, "arena_lookup" the same ones after a full parse.
+    Results are printed to stdout as a JSON array.
+    usage: json_benchmark [min_size [max_size]]
+*/
+
+namespace {
+
+using namespace ctjson;
+
+struct result {
+    std::string parser;
+    size_t bytes;
+    size_t iterations;
+    double seconds;
+};
+
+struct heap_value {
+    JSONNode::Type type {JSONNode::Type::Null};
+    bool boolean {false};
+    int64_t integer {0};
+    double number {0.0};
+    std::unique_ptr<std::string> string;
+    std::unique_ptr<std::vector<heap_value>> array;
+    std::unique_ptr<std::map<std::string, heap_value>> object;
+};
+
+class heap_parser {
+public:
+    heap_parser(const std::string& input)
+        : input_(input)
+    {
+    }
+
+    bool parse(heap_value& result)
+    {
+        return parse_value(next(), result);
+    }
+
+private:
+    JSONToken next()
+    {
+        pos_ = skipWhitespace(input_.data(), input_.size(), pos_);
+        if (pos_ >= input_.size())
+            return { TokenType::Invalid, pos_, 0 };
+        const JSONToken token = classifyToken(input_.data(), input_.size(), pos_);
+        pos_ += token.length;
+        return token;
+    }
+
+    bool parse_value(const JSONToken& token, heap_value& result)
+    {
+        const char* str = input_.data() + token.offset;
+        switch (token.type) {
+        case TokenType::String:
+            result.type = JSONNode::Type::String;
+            result.string.reset(new std::string(str + 1, token.length - 2));
+            return true;
+        case TokenType::Number:
+            if (isIntegerNumber(str, token.length)) {
+                result.type = JSONNode::Type::Integer;
+                result.integer = parseInt64(str, token.length);
+            } else {
+                result.type = JSONNode::Type::Number;
+                result.number = parseDouble(str, token.length);
+            }
+            return true;
+        case TokenType::Boolean:
+            result.type = JSONNode::Type::Boolean;
+            result.boolean = (token.length == 4);
+            return true;
+        case TokenType::Null:
+            return true;
+        case TokenType::ArrayOpen: {
+            result.type = JSONNode::Type::Array;
+            result.array.reset(new std::vector<heap_value>());
+            JSONToken token = next();
+            while (token.type != TokenType::ArrayClose) {
+                result.array->emplace_back();
+                if (!parse_value(token, result.array->back()))
+                    return false;
+                token = next();
+                if (token.type == TokenType::Comma)
+                    token = next();
+            }
+            return true;
+        }
+        case TokenType::DictOpen: {
+            result.type = JSONNode::Type::Object;
+            result.object.reset(new std::map<std::string, heap_value>());
+            JSONToken token = next();
+            while (token.type == TokenType::String) {
+                std::string name(input_.data() + token.offset + 1, token.length - 2);
+                if (next().type != TokenType::Colon)
+                    return false;
+                if (!parse_value(next(), (*result.object)[name]))
+                    return false;
+                token = next();
+                if (token.type == TokenType::Comma)
+                    token = next();
+            }
+            return token.type == TokenType::DictClose;
+        }
+        default:
+            return false;
+        }
+    }
+
+    const std::string& input_;
+    size_t pos_ = 0;
+};
+
+static std::string generate_document(size_t size)
+{
+    std::string out = "{\"records\": [";
+    for (size_t i = 0; out.size() < size; ++i) {
+        const std::string id = std::to_string(i);
+        out += (i ? ", " : "");
+        out += "{\"id\": " + id + ", \"name\": \"item " + id + "\", \"score\": " + id + ".25e-1, \"active\": "
+            + (i % 2 ? "true" : "false") + ", \"tags\": [\"a\", \"b\", null], \"pos\": {\"x\": " + id + ", \"y\": -" + id + "}}";
+    }
+    return out + "]}";
+}
+
+static constexpr const char record_schema_text[] = R"({
+    "type": "object",
+    "required": ["records"],
+    "properties": {
+        "records": {"type": "array", "items": {
+            "type": "object",
+            "required": ["id", "name", "pos"],
+            "properties": {
+                "id": {"type": "integer", "minimum": 0},
+                "name": {"type": "string"},
+                "score": {"type": "number"},
+                "active": {"type": "boolean"},
+                "tags": {"type": "array", "items": {"enum": ["a", "b", null]}},
+                "pos": {"type": "object", "properties": {"x": {"type": "integer"}, "y": {"type": "integer"}}}
+            }
+        }}
+    }
+})";
+static constexpr auto record_schema = compileSchema<record_schema_text>();
+
+// prevents the compiler from removing the benchmarked code
+static volatile size_t sink;
+
+template <typename Function>
+static result measure(const std::string& parser, size_t bytes, Function&& function)
+{
+    using clock = std::chrono::steady_clock;
+    constexpr double min_seconds = 0.2;
+    size_t iterations = 0;
+    double seconds = 0.0;
+    const auto start = clock::now();
+    do {
+        function();
+        ++iterations;
+        seconds = std::chrono::duration<double>(clock::now() - start).count();
+    } while (seconds < min_seconds);
+    return result{parser, bytes, iterations, seconds};
+}
+
+static void print(std::ostream& out, const result& r, bool last)
+{
+    const double total_bytes = static_cast<double>(r.bytes) * static_cast<double>(r.iterations);
+    out << "  {\"parser\": \"" << r.parser << "\", \"bytes\": " << r.bytes
+        << ", \"iterations\": " << r.iterations << ", \"seconds\": " << r.seconds
+        << ", \"mb_per_s\": " << total_bytes / r.seconds / 1e6 << '}' << (last ? "\n" : ",\n");
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    size_t min_size = 1024;
+    size_t max_size = 64 * 1024 * 1024;
+    if (argc > 1)
+        min_size = std::stoul(argv[1]);
+    if (argc > 2)
+        max_size = std::stoul(argv[2]);
+
+    std::vector<result> results;
+    for (size_t size = min_size; size <= max_size; size *= 4) {
+        const std::string input = generate_document(size);
+
+        results.push_back(measure("structural_index", input.size(), [&]() {
+            sink = JSONStructuralIndex(input.data(), input.size()).size();
+        }));
+        results.push_back(measure("arena", input.size(), [&]() {
+            JSONDocument document(input);
+            sink = document.success() ? document.root().size() : 0;
+        }));
+        results.push_back(measure("schema_validation", input.size(), [&]() {
+            sink = validateJSON(record_schema, input.data(), input.size()).offset;
+        }));
+        const size_t last = JSONDocument(input).root().find("\"records\"")->size() - 1;
+        results.push_back(measure("on_demand", input.size(), [&]() {
+            const JSONLazyValue record = JSONLazyValue(input)["\"records\""][last];
+            sink = static_cast<size_t>(record["\"id\""].get<int64_t>() + record["\"pos\""]["\"y\""].get<int64_t>())
+                + record["\"name\""].get<StringView>().value().size();
+        }));
+        results.push_back(measure("arena_lookup", input.size(), [&]() {
+            JSONDocument document(input);
+            const JSONNode* records = document.root().find("\"records\"");
+            const JSONNode& record = (*records)[last];
+            sink = static_cast<size_t>(record.get<int64_t>("\"id\"") + record.get<int64_t>("\"y\""))
+                + record.get<StringView>("\"name\"").value().size();
+        }));
+        results.push_back(measure("heap", input.size(), [&]() {
+            heap_value document;
+            sink = heap_parser(input).parse(document) ? document.object->size() : 0;
+        }));
+        std::cerr << "done: " << size << " bytes\n";
+    }
+
+    std::cout << "[\n";
+    for (size_t i = 0; i < results.size(); ++i)
+        print(std::cout, results[i], i + 1 == results.size());
+    std::cout << "]\n";
+    return 0;
+}
@@ -0,0 +1,9 @@
+#!/bin/bash
+# builds and runs the runtime JSON parsing benchmark, JSON results are written to json_benchmark.json
+# CXXFLAGS selects the instruction set of the structural index, e.g. -mno-avx2 for the SSE2 version
+g++ -O2 ${CXXFLAGS:--march=native} -std=c++17 -I. runtime_benchmark.cpp -Wall -o json_benchmark
+if [[ $? -ne 0 ]]; then
+	echo "g++ build failed!"
+	exit 1
+fi
+./json_benchmark "$@" > json_benchmark.json